@@ -0,0 +1,59 @@
+#include "AutoSaveControl.h"
+#include <App/Application.h>
+#include <Base/Parameter.h>
+#include <Gui/AutoSaver.h>
+
+namespace Dev
+{
+    namespace
+    {
+        constexpr int kDefaultTimeoutMinutes = 15;
+
+        int g_suspend_depth = 0;
+        bool g_covered_by_journal = false;
+        // 最近一次设置给AutoSaver的间隔，相同时不再设置，避免重启定时器
+        int g_applied_timeout = -1;
+    } // namespace
+
+    void AutoSaveControl::Suspend()
+    {
+        ++g_suspend_depth;
+        Apply();
+    }
+
+    void AutoSaveControl::Resume()
+    {
+        if (g_suspend_depth > 0)
+            --g_suspend_depth;
+        Apply();
+    }
+
+    void AutoSaveControl::SetCoveredByJournal(bool covered)
+    {
+        g_covered_by_journal = covered;
+        Apply();
+    }
+
+    int AutoSaveControl::GetConfiguredTimeout()
+    {
+        auto grp = app::GetApplication().GetUserParameter().GetGroup("BaseApp/Preferences/Document");
+        if (!grp)
+            return kDefaultTimeoutMinutes * 60 * 1000;
+        if (!grp->GetBool("AutoSaveEnabled", true))
+            return 0;
+        return static_cast<int>(grp->GetInt("AutoSaveTimeout", kDefaultTimeoutMinutes)) * 60 * 1000;
+    }
+
+    void AutoSaveControl::Apply()
+    {
+        int timeout = g_suspend_depth > 0 || g_covered_by_journal ? 0 : GetConfiguredTimeout();
+        if (timeout == g_applied_timeout)
+            return;
+        auto saver = gui::AutoSaver::Instance();
+        if (!saver)
+            return;
+        saver->SetTimeout(timeout);
+        g_applied_timeout = timeout;
+    }
+
+} // namespace Dev
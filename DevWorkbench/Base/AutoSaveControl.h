@@ -0,0 +1,29 @@
+#pragma once
+
+namespace Dev {
+
+/**
+ * @brief 主程序自动保存（gui::AutoSaver）的暂停
+ *
+ * AutoSaver按自己的定时器在GUI线程中序列化整个文档，导入期间处理事件时可能写出半个文档。
+ * Suspend、Resume成对调用，计数大于0时把AutoSaver的间隔设为0，全部Resume后恢复用户参数
+ * BaseApp/Preferences/Document 下 AutoSaveEnabled、AutoSaveTimeout（分钟）的设置。
+ * 所有打开的文档都由RecoveryJournal完整记录时，AutoSaver的整文档保存同样停用，避免定时在GUI线程序列化整个文档。
+ * 只在GUI线程中使用。
+ */
+class AutoSaveControl
+{
+  public:
+    static void Suspend();
+    static void Resume();
+    // 由RecoveryJournal在文档与修改记录变化后调用
+    static void SetCoveredByJournal(bool covered);
+
+    // 用户参数中的自动保存间隔（毫秒），关闭时为0
+    static int GetConfiguredTimeout();
+
+  private:
+    static void Apply();
+};
+
+}  // namespace Dev
@@ -1,17 +1,34 @@
 #include "DevSetup.h"
 #include "PartCollection.h"
+#include "ShapeTransaction.h"
+#include "Storage/AttachmentStore.h"
+#include "Storage/RecoveryJournal.h"
+#include "Storage/SortListCodec.h"
 #include <App/Application.h>
 #include <App/Document.h>
+#include <Base/Parameter.h>
 #include <Base/Navigator/PartNavigator.h>
 #include <Gui/MainWindow.h>
 #include <Gui/Selection/Selection.h>
 #include <Gui/View/MdiView.h>
 #include <Base/Object/CurvesLoftObject.h>
 #include <App/DocumentObjectWireframedMarker.h>
+#include <Base/ViewProvider/ViewProviderPart.h>
 
 PFC_TYPESYSTEM_IMPL(Dev::DevSetup, app::DocumentObject)
 namespace Dev
 {
+    namespace
+    {
+        // û BaseApp/Preferences/Mod/Dev/Document/BinarySortListرʱ԰XML
+        bool IsBinarySortListEnabled()
+        {
+            auto grp = app::GetApplication().GetUserParameter().GetGroup("BaseApp/Preferences/Mod/Dev/Document");
+            if (!grp)
+                return true;
+            return grp->GetBool("BinarySortList", true);
+        }
+    } // namespace
 
     DevSetup::DevSetup()
         : part_collection(nullptr)
@@ -71,14 +88,51 @@ namespace Dev
         }
         else
         {
-            auto obj = new app::DocumentObjectTopoShape();
+            // ͨʹViewProviderPartʾڴ汣
             auto unique_name = part_collection->GetUniqueName(name);
+            auto obj = static_cast<app::DocumentObjectTopoShape *>(GetDocument()->AddObject(app::DocumentObjectTopoShape::GetClassType().GetName(), {}, true, ViewProviderPart::GetClassType().GetName()));
             obj->Label.SetValue(unique_name);
-            GetDocument()->AddObject(std::unique_ptr<app::DocumentObjectTopoShape>(obj));
             return obj;
         }
     }
 
+    std::vector<app::DocumentObjectTopoShape *> DevSetup::AddParts(std::span<const PartSpec> specs,
+                                                                   const std::function<void(std::size_t, app::DocumentObjectTopoShape *)> &on_created)
+    {
+        std::vector<app::DocumentObjectTopoShape *> objects;
+        if (specs.empty())
+            return objects;
+        objects.reserve(specs.size());
+
+        // ÷δʱд򿪣֤һγ
+        bool own_transaction = app::GetApplication().GetActiveTransaction().empty();
+        if (own_transaction)
+            app::OpenCommand("Add Parts");
+
+        try
+        {
+            PartCollection::ScopedBatch batch(part_collection);
+            for (auto const &spec : specs)
+            {
+                auto obj = AddPart(spec.name, spec.isWireframedMark);
+                obj->Shape.SetValue(spec.shape);
+                objects.push_back(obj);
+                if (on_created)
+                    on_created(objects.size() - 1, obj);
+            }
+        }
+        catch (...)
+        {
+            if (own_transaction)
+                app::AbortCommand();
+            throw;
+        }
+
+        if (own_transaction)
+            app::CommitCommand();
+        return objects;
+    }
+
  BoxObject *DevSetup::AddBoxObject(std::string_view name)
     {
         auto obj = new BoxObject();
@@ -131,6 +185,8 @@ namespace Dev
         if (!doc)
             return;
 
+        ShapeTransaction::ApplyUndoLimit(doc);
+
         auto parts = GetObjects<app::DocumentObjectTopoShape>(doc);
 
         auto part_sort_list = part_collection->GetSortList();
@@ -147,13 +203,27 @@ namespace Dev
         }
 
         part_collection->Setup(doc, parts);
+        RecoveryJournal::GetInstance().Attach(doc, part_collection);
     }
 
     void DevSetup::Store(base::XMLWriter &writer, std::uint32_t version) const
     {
         writer.WriteAttributeBool("PartCollection", true);
+        bool binary = IsBinarySortListEnabled();
+        if (binary)
+            writer.WriteAttributeBool("BinarySortList", true);
         DevObject::Store(writer, version);
 
+        if (binary)
+        {
+            SortListCodec::Data data{nav_sort_list, part_collection->GetSortList()};
+            writer.WriteStartElement("SortList");
+            AttachmentStore::Write(writer, "file", "DevSortList.bin", this, [data = std::move(data)](std::ostream &os)
+                                   { return SortListCodec::Write(os, data); });
+            writer.WriteEndElement("SortList");
+            return;
+        }
+
         {
             writer.WriteStartElement("NavSortList");
             writer.WriteAttributeInteger("Count", static_cast<std::uint32_t>(nav_sort_list.size()));
@@ -210,7 +280,27 @@ namespace Dev
     void DevSetup::Restore(base::XMLReader &reader, std::uint32_t version)
     {
         bool isPartCollection = reader.HasAttribute("PartCollection");
+        bool isBinarySortList = reader.HasAttribute("BinarySortList");
         DevObject::Restore(reader, version);
+
+        if (isBinarySortList)
+        {
+            // XMLȡɺŶȡǰΪ
+            nav_sort_list.clear();
+            part_collection->SetSortList({});
+            reader.ReadElement("SortList");
+            AttachmentStore::Read(reader, "file", [this](std::istream &is)
+                                  {
+                                      SortListCodec::Data data;
+                                      if (!SortListCodec::Read(is, data))
+                                          return false;
+                                      nav_sort_list = std::move(data.nav_sort_list);
+                                      part_collection->SetSortList(data.part_sort_list);
+                                      return true; });
+            reader.ReadEndElement("SortList");
+            return;
+        }
+
         {
             reader.ReadElement("NavSortList");
             nav_sort_list.clear();
@@ -296,12 +386,16 @@ namespace Dev
 
     void DevSetup::OnFinishRestoreDocument(const app::Document &doc)
     {
-        if (&doc == GetDocument())
-            Setup();
+        if (&doc != GetDocument())
+            return;
+        Setup();
+        RecoveryJournal::GetInstance().OfferRecovery(GetDocument());
     }
 
     void DevSetup::OnBeforeDeletingDocument(const app::Document &doc)
     {
+        if (&doc == GetDocument())
+            RecoveryJournal::GetInstance().Detach(&doc);
         // if (&doc == GetDocument())
         //     toolpath_mgr->CleanTool();
     }
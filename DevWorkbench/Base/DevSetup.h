@@ -1,6 +1,9 @@
 #pragma once
 
+#include <functional>
+#include <span>
 #include <AMCAXRender.h>
+#include <topology/TopoShape.hpp>
 #include <Base/Object/DevObject.h>
 #include <Base/PartCollection.h>
 #include <Base/Navigator/PartNavigator.h>
@@ -30,6 +33,17 @@ namespace Dev
 
     PartCollection *DevPartCollection();
     app::DocumentObjectTopoShape *AddPart(std::string_view name, bool isWireframedMark = false);
+
+    struct PartSpec
+    {
+      std::string name;
+      AMCAX::TopoShape shape;
+      bool isWireframedMark = false;
+    };
+    // 批量创建部件：整批处于同一事务中，导航栏只在结束时收到一次SignalNewObjects；
+    // on_created在批量内对每个新对象调用，可用于设置颜色等属性而不触发逐个刷新
+    std::vector<app::DocumentObjectTopoShape *> AddParts(std::span<const PartSpec> specs,
+                                                         const std::function<void(std::size_t, app::DocumentObjectTopoShape *)> &on_created = {});
     BoxObject *AddBoxObject(std::string_view name);
     CurvesLoftObject *AddCurvesLoft(std::string_view name);
     RenderDistanceObject *AddRenderDistanceObject(std::string_view name);
@@ -0,0 +1,30 @@
+#include "ElementName.h"
+
+namespace Dev
+{
+    bool FullNameView::Parse(std::string_view full_name, FullNameView &out)
+    {
+        out = FullNameView();
+        auto first = full_name.find('.');
+        if (first == std::string_view::npos)
+            return false;
+        auto second = full_name.find('.', first + 1);
+        if (second == std::string_view::npos || full_name.find('.', second + 1) != std::string_view::npos)
+            return false;
+
+        out.document = full_name.substr(0, first);
+        out.object = full_name.substr(first + 1, second - first - 1);
+        out.sub = full_name.substr(second + 1);
+        out.element = SubElementId::Parse(out.sub);
+        return true;
+    }
+
+    std::string MakeFullName(std::string_view document, std::string_view object, std::string_view sub)
+    {
+        std::string full_name;
+        full_name.reserve(document.size() + object.size() + sub.size() + 2);
+        full_name.append(document).append(1, '.').append(object).append(1, '.').append(sub);
+        return full_name;
+    }
+
+} // namespace Dev
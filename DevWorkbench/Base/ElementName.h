@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <Base/SubShapeIndex.h>
+
+namespace Dev {
+
+/**
+ * @brief "doc.object.Face12"形式完整名称的只读视图
+ *
+ * 各段直接指向原字符串，解析时不分配内存，原字符串需在视图使用期间保持有效。
+ */
+struct FullNameView
+{
+    std::string_view document;
+    std::string_view object;
+    std::string_view sub;
+    SubElementId element;  // sub解析后的子元素编号，sub不是子元素名称时无效
+
+    // 名称必须恰好由三段组成，否则返回false且out保持为空
+    static bool Parse(std::string_view full_name, FullNameView& out);
+};
+
+// 拼接完整名称，只分配一次内存
+std::string MakeFullName(std::string_view document, std::string_view object, std::string_view sub);
+
+}  // namespace Dev
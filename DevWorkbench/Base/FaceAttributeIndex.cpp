@@ -0,0 +1,150 @@
+#include "FaceAttributeIndex.h"
+#include "SubShapeIndex.h"
+#include <App/DocumentObjectTopoShape.h>
+#include <algorithm>
+
+namespace Dev
+{
+    FaceAttributeIndex &FaceAttributeIndex::GetInstance()
+    {
+        static FaceAttributeIndex instance;
+        return instance;
+    }
+
+    std::vector<AMCAX::TopoShape> FaceAttributeIndex::FindFacesByColor(const app::DocumentObjectTopoShape *object, const app::Color &color)
+    {
+        return FindColor(object, color, false);
+    }
+
+    std::vector<AMCAX::TopoShape> FaceAttributeIndex::FindOneFaceByColor(const app::DocumentObjectTopoShape *object, const app::Color &color)
+    {
+        return FindColor(object, color, true);
+    }
+
+    std::vector<AMCAX::TopoShape> FaceAttributeIndex::FindColor(const app::DocumentObjectTopoShape *object, const app::Color &color, bool first_only)
+    {
+        std::vector<AMCAX::TopoShape> faces;
+        if (!object)
+            return faces;
+
+        auto &entry = EnsureColors(object);
+        auto it = entry.faces_by_color.find(color.GetPackedValue());
+        if (it == entry.faces_by_color.end())
+            return faces;
+
+        auto const &colors = object->FaceColors.GetValues();
+        for (int index : it->second)
+        {
+            // 量化后相同的颜色不一定相等，与FaceColors中的值精确比较
+            auto value = colors.find(index);
+            if (value == colors.end() || value->second != color)
+                continue;
+            auto face = SubShapeIndex::GetInstance().GetSubShape(object, SubElementId{AMCAX::ShapeType::Face, index});
+            if (face.IsNull())
+                continue;
+            faces.push_back(face);
+            if (first_only)
+                break;
+        }
+        return faces;
+    }
+
+    std::vector<AMCAX::TopoShape> FaceAttributeIndex::FindFacesByName(const app::DocumentObjectTopoShape *object, std::string_view face_name)
+    {
+        std::vector<AMCAX::TopoShape> faces;
+        if (!object)
+            return faces;
+
+        auto &entry = EnsureNames(object);
+        auto it = entry.faces_by_name.find(face_name);
+        if (it == entry.faces_by_name.end())
+            return faces;
+
+        faces.reserve(it->second.size());
+        for (int index : it->second)
+        {
+            auto face = SubShapeIndex::GetInstance().GetSubShape(object, SubElementId{AMCAX::ShapeType::Face, index});
+            if (!face.IsNull())
+                faces.push_back(face);
+        }
+        return faces;
+    }
+
+    std::string_view FaceAttributeIndex::GetNameByFace(const app::DocumentObjectTopoShape *object, const AMCAX::TopoShape &face)
+    {
+        if (!object)
+            return std::string_view();
+
+        auto id = SubShapeIndex::GetInstance().GetSubElementId(object, face);
+        if (!id.IsValid() || id.type != AMCAX::ShapeType::Face)
+            return std::string_view();
+
+        auto &entry = EnsureNames(object);
+        auto it = entry.name_by_face.find(id.index);
+        return it == entry.name_by_face.end() ? std::string_view() : std::string_view(it->second);
+    }
+
+    void FaceAttributeIndex::OnPropertyChanged(const app::DocumentObjectTopoShape *object, const app::Property &prop)
+    {
+        auto it = m_entries.find(object);
+        if (it == m_entries.end())
+            return;
+
+        if (&prop == &object->FaceColors)
+        {
+            it->second.has_colors = false;
+            it->second.faces_by_color.clear();
+        }
+        else if (&prop == &object->FaceNames)
+        {
+            it->second.has_names = false;
+            it->second.faces_by_name.clear();
+            it->second.name_by_face.clear();
+        }
+    }
+
+    void FaceAttributeIndex::Remove(const app::DocumentObjectTopoShape *object)
+    {
+        m_entries.erase(object);
+    }
+
+    void FaceAttributeIndex::Clear()
+    {
+        m_entries.clear();
+    }
+
+    FaceAttributeIndex::Entry &FaceAttributeIndex::EnsureColors(const app::DocumentObjectTopoShape *object)
+    {
+        auto &entry = m_entries[object];
+        if (entry.has_colors)
+            return entry;
+
+        for (auto const &[index, color] : object->FaceColors.GetValues())
+            entry.faces_by_color[color.GetPackedValue()].push_back(index);
+        // FaceColors本身无序，按面序号排列使FindOneFaceByColor的结果稳定
+        for (auto &[packed, indices] : entry.faces_by_color)
+            std::sort(indices.begin(), indices.end());
+        entry.has_colors = true;
+        return entry;
+    }
+
+    FaceAttributeIndex::Entry &FaceAttributeIndex::EnsureNames(const app::DocumentObjectTopoShape *object)
+    {
+        auto &entry = m_entries[object];
+        if (entry.has_names)
+            return entry;
+
+        // FaceNames以"Face12"形式的子元素名称为键
+        for (auto const &[sub_name, name] : object->FaceNames.GetValues())
+        {
+            auto id = SubElementId::Parse(sub_name);
+            if (!id.IsValid() || id.type != AMCAX::ShapeType::Face)
+                continue;
+            entry.faces_by_name[name].push_back(id.index);
+            entry.name_by_face[id.index] = name;
+        }
+        entry.has_names = true;
+        return entry;
+    }
+
+} // namespace Dev
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <topology/TopoShape.hpp>
+
+namespace app {
+class Color;
+class DocumentObjectTopoShape;
+class Property;
+}
+
+namespace Dev {
+
+/**
+ * @brief 部件面颜色、面名称的倒排索引
+ *
+ * 与app::DocumentObjectTopoShape::FindFacesByColor等接口语义相同，但不逐个扫描FaceColors、FaceNames，
+ * 查询代价只与结果数量有关。索引在第一次查询时建立（包括文档恢复后），
+ * FaceColors、FaceNames变化时由PartCollection调用OnPropertyChanged使对应的索引作废。
+ */
+class FaceAttributeIndex
+{
+  public:
+    static FaceAttributeIndex& GetInstance();
+
+    std::vector<AMCAX::TopoShape> FindFacesByColor(const app::DocumentObjectTopoShape* object, const app::Color& color);
+    // 只返回第一个符合的面，没有时返回空
+    std::vector<AMCAX::TopoShape> FindOneFaceByColor(const app::DocumentObjectTopoShape* object, const app::Color& color);
+    std::vector<AMCAX::TopoShape> FindFacesByName(const app::DocumentObjectTopoShape* object, std::string_view face_name);
+    std::string_view GetNameByFace(const app::DocumentObjectTopoShape* object, const AMCAX::TopoShape& face);
+
+    void OnPropertyChanged(const app::DocumentObjectTopoShape* object, const app::Property& prop);
+    void Remove(const app::DocumentObjectTopoShape* object);
+    void Clear();
+
+  private:
+    FaceAttributeIndex() = default;
+
+    struct StringHash
+    {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view str) const { return std::hash<std::string_view>{}(str); }
+    };
+
+    struct Entry
+    {
+        bool has_colors = false;
+        bool has_names = false;
+        // 8位量化后的RGBA到FaceColors中的面序号，同一桶内再按颜色精确比较
+        std::unordered_map<std::uint32_t, std::vector<int>> faces_by_color;
+        std::unordered_map<std::string, std::vector<int>, StringHash, std::equal_to<>> faces_by_name;
+        std::unordered_map<int, std::string> name_by_face;
+    };
+
+    Entry& EnsureColors(const app::DocumentObjectTopoShape* object);
+    Entry& EnsureNames(const app::DocumentObjectTopoShape* object);
+    std::vector<AMCAX::TopoShape> FindColor(const app::DocumentObjectTopoShape* object, const app::Color& color, bool first_only);
+
+  private:
+    std::unordered_map<const app::DocumentObjectTopoShape*, Entry> m_entries;
+};
+
+}  // namespace Dev
@@ -0,0 +1,29 @@
+#include "ImportGuard.h"
+#include <Base/AutoSaveControl.h>
+
+namespace Dev
+{
+    namespace
+    {
+        int g_depth = 0;
+    } // namespace
+
+    ImportGuard::ImportGuard()
+    {
+        // 主程序的自动保存不受插件定时器推迟的影响，导入期间停止
+        if (g_depth++ == 0)
+            AutoSaveControl::Suspend();
+    }
+
+    ImportGuard::~ImportGuard()
+    {
+        if (--g_depth == 0)
+            AutoSaveControl::Resume();
+    }
+
+    bool ImportGuard::IsActive()
+    {
+        return g_depth > 0;
+    }
+
+} // namespace Dev
@@ -0,0 +1,25 @@
+#pragma once
+
+namespace Dev {
+
+/**
+ * @brief 导入进行中的标记
+ *
+ * 导入期间为了显示进度会在事务打开的情况下处理事件，定时器回调可能在事务中途执行。
+ * 在导入期间存在ImportGuard对象，会读写文档或同步生成网格的定时器据此推迟到导入结束后执行。
+ * 主程序的自动保存（gui::AutoSaver）不经过这里判断，最外层的ImportGuard存在期间通过AutoSaveControl暂停。
+ * 只在GUI线程中使用。
+ */
+class ImportGuard
+{
+  public:
+    ImportGuard();
+    ~ImportGuard();
+
+    ImportGuard(const ImportGuard&) = delete;
+    ImportGuard& operator=(const ImportGuard&) = delete;
+
+    static bool IsActive();
+};
+
+}  // namespace Dev
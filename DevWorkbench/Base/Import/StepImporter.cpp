@@ -0,0 +1,380 @@
+#include "StepImporter.h"
+#include <App/Application.h>
+#include <App/Color.h>
+#include <App/DocumentObjectTopoShape.h>
+#include <Base/Import/ImportGuard.h>
+#include <Base/Parameter.h>
+#include <Base/SubShapeIndex.h>
+#include <Base/Tools.h>
+#include <Gui/Application.h>
+#include <Gui/MainWindow.h>
+#include <Gui/View/MdiView.h>
+#include <Gui/ViewProvider/ViewProviderDocumentObjectTopoShape.h>
+#include <Logging/Logging.h>
+#include <QCoreApplication>
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <step/STEPStyledReader.hpp>
+#include <step/STEPTool.hpp>
+#include <topology/TopoExplorerTool.hpp>
+#include <topology/TopoIterator.hpp>
+
+namespace Dev
+{
+    namespace
+    {
+        std::string DecodeProductName(const std::string &product_name)
+        {
+            std::string name = base::Tools::DecodeEncodedUnicode(product_name);
+            name.erase(std::remove(name.begin(), name.end(), '\n'), name.end());
+            return name;
+        }
+
+        bool IsWireFrameRepresentation(const AMCAX::STEP::ShapeRepresentationType &represent)
+        {
+            return represent == AMCAX::STEP::ShapeRepresentationType::GEOMETRICALLY_BOUNDED_WIREFRAME_SHAPE_REPRESENTATION;
+        }
+    } // namespace
+
+    StepImporter::Options StepImporter::Options::FromParameter()
+    {
+        Options options;
+        auto grp = app::GetApplication().GetUserParameter().GetGroup("BaseApp/Preferences/Mod/Dev/Import");
+        if (!grp)
+            return options;
+        options.streaming = grp->GetBool("StepStreaming", options.streaming);
+        options.translation_threads = grp->GetInt("StepTranslationThreads", static_cast<int>(options.translation_threads));
+        options.concurrent_meshing = grp->GetBool("StepConcurrentMeshing", options.concurrent_meshing);
+        options.meshing_threads = grp->GetInt("StepMeshingThreads", static_cast<int>(options.meshing_threads));
+        return options;
+    }
+
+    StepImporter::StepImporter(Options options)
+        : m_options(options), m_reader(nullptr), m_received_shapes(false), m_first_flush(true)
+    {
+    }
+
+    StepImporter::~StepImporter()
+    {
+    }
+
+    bool StepImporter::Import(const std::filesystem::path &path)
+    {
+        std::ifstream ifs(path);
+        AMCAX::STEP::STEPStyledReader reader(ifs);
+
+        auto options = reader.GetOptions();
+        options.ReaderConcurrency = m_options.translation_threads;
+        options.ReaderMeshingConcurrent = m_options.concurrent_meshing;
+        options.ReaderMeshingConcurrency = m_options.meshing_threads;
+        reader.SetOptions(options);
+
+        if (!m_options.streaming)
+        {
+            if (!reader.Read())
+                return false;
+            CreateFlattened(reader.GetProducts());
+            return true;
+        }
+
+        return ReadStreaming(reader);
+    }
+
+    bool StepImporter::ReadStreaming(AMCAX::STEP::STEPStyledReader &reader)
+    {
+        m_reader = &reader;
+        m_occurrences.clear();
+        m_ready_shapes.clear();
+        m_received_shapes = false;
+        m_first_flush = true;
+        // 下面处理事件时导入事务仍处于打开状态
+        ImportGuard guard;
+
+        // 读取在后台线程中进行，回调可能来自读取器内部的多个线程
+        auto reading = std::async(std::launch::async, [this, &reader]()
+                                  { return reader.Read([this](AMCAX::STEP::STEPDataEvent event, std::shared_ptr<AMCAX::STEP::STEPStyledProduct> product, std::size_t index)
+                                                       { OnStepData(event, std::move(product), index); }); });
+
+        // 等待期间在GUI线程中创建已就绪的部件，并处理绘制事件使其尽早显示
+        while (reading.wait_for(std::chrono::milliseconds(50)) != std::future_status::ready)
+        {
+            FlushReadyShapes();
+            QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+        }
+        bool success = reading.get();
+        m_reader = nullptr;
+
+        {
+            // 读取器没有发出ProductReady时，读取完成后产品树已完整，在此补充收集
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_occurrences.empty())
+            {
+                for (auto const &root : reader.GetProducts())
+                    CollectOccurrences(root, AMCAX::TopoLocation());
+            }
+        }
+        FlushReadyShapes(true);
+
+        // 读取器没有逐个通知形状时，退回到读取完成后统一创建
+        if (success && !m_received_shapes)
+            CreateFlattened(reader.GetProducts());
+
+        return success;
+    }
+
+    void StepImporter::OnStepData(AMCAX::STEP::STEPDataEvent event, std::shared_ptr<AMCAX::STEP::STEPStyledProduct> product, std::size_t index)
+    {
+        switch (event)
+        {
+        case AMCAX::STEP::STEPDataEvent::ProductReady:
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_occurrences.clear();
+            for (auto const &root : m_reader->GetProducts())
+                CollectOccurrences(root, AMCAX::TopoLocation());
+            break;
+        }
+        case AMCAX::STEP::STEPDataEvent::ShapeReady:
+        {
+            if (!product || index >= product->ShapesSize())
+                break;
+            ReadyShape ready;
+            ready.product = product.get();
+            ready.name = DecodeProductName(product->ProductName());
+            ready.shape = product->ShapeAt(index);
+            ready.styles = index < product->PropertiesSize() ? BuildStyleIndex(product->PropertyAt(index)) : std::make_shared<const StyleIndex>();
+            ready.isWireFrame = index < product->ShapeRepresentationsSize() && IsWireFrameRepresentation(product->ShapeRepresentationAt(index));
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_ready_shapes.push_back(std::move(ready));
+            m_received_shapes = true;
+            break;
+        }
+        case AMCAX::STEP::STEPDataEvent::Error:
+            LOGGING_ERROR("STEP reader entered an error state.");
+            break;
+        default:
+            break;
+        }
+    }
+
+    void StepImporter::CollectOccurrences(const std::shared_ptr<AMCAX::STEP::STEPStyledProduct> &node, const AMCAX::TopoLocation &parent_location)
+    {
+        if (!node)
+            return;
+
+        AMCAX::TopoLocation location = parent_location * node->Location();
+
+        // 实例节点的几何由其目标产品持有，形状就绪通知也针对目标产品
+        const AMCAX::STEP::STEPStyledProduct *owner = node.get();
+        while (owner->IsShadow() && owner->Target())
+            owner = owner->Target().get();
+        m_occurrences[owner].push_back({DecodeProductName(node->ProductName()), location});
+
+        for (auto const &child : node->Children())
+            CollectOccurrences(child, location);
+    }
+
+    void StepImporter::FlushReadyShapes(bool final)
+    {
+        std::vector<std::pair<ReadyShape, std::vector<Occurrence>>> ready;
+        std::size_t unmatched = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            // 产品树尚未就绪时无法确定形状在装配中的位置，继续等待
+            if ((!final && m_occurrences.empty()) || m_ready_shapes.empty())
+                return;
+            ready.reserve(m_ready_shapes.size());
+            std::vector<ReadyShape> waiting;
+            for (auto &shape : m_ready_shapes)
+            {
+                auto it = m_occurrences.find(shape.product);
+                if (it != m_occurrences.end())
+                {
+                    ready.emplace_back(std::move(shape), it->second);
+                }
+                else if (final)
+                {
+                    // 读取结束后仍不在产品树中，按产品坐标系放置，避免丢失几何
+                    std::vector<Occurrence> occurrences{{shape.name, AMCAX::TopoLocation()}};
+                    ready.emplace_back(std::move(shape), std::move(occurrences));
+                    ++unmatched;
+                }
+                else
+                {
+                    // 产品树可能稍后才包含该产品，留到下一次
+                    waiting.push_back(std::move(shape));
+                }
+            }
+            m_ready_shapes = std::move(waiting);
+        }
+        if (unmatched > 0)
+            LOGGING_WARN << unmatched << " STEP shapes were not found in the product tree and were placed at the origin.";
+
+        for (auto const &[shape, occurrences] : ready)
+        {
+            for (auto const &occurrence : occurrences)
+                CreateParts(occurrence.name, shape.shape, occurrence.location, shape.styles, shape.isWireFrame);
+        }
+        CommitParts();
+
+        if (m_first_flush)
+        {
+            m_first_flush = false;
+            gui::GetMainWindow()->ActiveWindow()->OnMessage("ViewAll");
+        }
+    }
+
+    void StepImporter::CreateFlattened(const std::vector<std::shared_ptr<AMCAX::STEP::STEPStyledProduct>> &products)
+    {
+        auto ds = products;
+        AMCAX::STEP::STEPTool::FlattenInplace(ds);
+
+        for (auto const &shape_data : ds)
+        {
+            if (shape_data->ShapesSize() > 0)
+            {
+                bool isWireFrame = IsWireFrameRepresentation(shape_data->ShapeRepresentations().front());
+                CreateParts(DecodeProductName(shape_data->ProductName()), shape_data->Shapes().front(), AMCAX::TopoLocation(), BuildStyleIndex(shape_data->PropertyAt(0)), isWireFrame);
+            }
+        }
+        CommitParts();
+    }
+
+    void StepImporter::CreateParts(const std::string &name,
+                                   const AMCAX::TopoShape &shape,
+                                   const AMCAX::TopoLocation &location,
+                                   const std::shared_ptr<const StyleIndex> &styles,
+                                   bool isWireFrame)
+    {
+        if (shape.Type() == AMCAX::ShapeType::Compound && !isWireFrame)
+        {
+            int i = 0;
+            for (auto iter = AMCAX::TopoIterator(shape); iter.More(); iter.Next())
+            {
+                auto sub_shape = iter.Value();
+                m_part_specs.push_back({name + "_" + std::to_string(i++), location.IsIdentity() ? sub_shape : sub_shape.Moved(location), false});
+                m_pending_parts.push_back({sub_shape, location, styles});
+            }
+        }
+        else
+        {
+            m_part_specs.push_back({name, location.IsIdentity() ? shape : shape.Moved(location), isWireFrame});
+            m_pending_parts.push_back({shape, location, styles});
+        }
+    }
+
+    void StepImporter::CommitParts()
+    {
+        if (m_part_specs.empty())
+            return;
+
+        DevSetup::GetCurDevSetup()->AddParts(m_part_specs, [this](std::size_t i, app::DocumentObjectTopoShape *object)
+                                             {
+                                                 auto const &pending = m_pending_parts[i];
+                                                 if (pending.styles)
+                                                     ApplyStyles(object, pending.local_shape, pending.location, *pending.styles); });
+
+        m_part_specs.clear();
+        m_pending_parts.clear();
+    }
+
+    std::shared_ptr<const StepImporter::StyleIndex> StepImporter::BuildStyleIndex(const std::unordered_map<AMCAX::TopoShape, AMCAX::STEP::ShapeProperty> &pcs)
+    {
+        auto index = std::make_shared<StyleIndex>();
+        index->reserve(pcs.size());
+        for (auto const &[pcs_shape, pcs_prop] : pcs)
+        {
+            ShapeStyle style;
+            auto shapestyle = pcs_prop.GetShapeStyle();
+            if (shapestyle.SurfaceStyleHasValue())
+            {
+                auto surfacestyle = shapestyle.GetColor();
+                if (surfacestyle.IsValidRGB())
+                {
+                    style.has_color = true;
+                    style.color = app::Color(surfacestyle.R(), surfacestyle.G(), surfacestyle.B(), surfacestyle.A());
+                }
+            }
+            if (pcs_prop.NameHasValue())
+            {
+                style.has_name = true;
+                style.name = pcs_prop.Name();
+            }
+            if (style.has_color || style.has_name)
+                index->emplace(pcs_shape, std::move(style));
+        }
+        return index;
+    }
+
+    /**
+     * shape为产品坐标系下的形状，样式索引以其为键；location为其在装配中的位置，
+     * 子面在对象中的id需按放置后的形状查询
+     */
+    void StepImporter::ApplyStyles(app::DocumentObjectTopoShape *object,
+                                   const AMCAX::TopoShape &shape,
+                                   const AMCAX::TopoLocation &location,
+                                   const StyleIndex &styles)
+    {
+        if (styles.empty())
+            return;
+
+        gui::ViewProviderDocumentObjectTopoShape *object_view_provider = nullptr;
+        auto view_provider = gui::GetGuiApplication()->GetViewProvider(object);
+        if (view_provider != nullptr)
+        {
+            object_view_provider = view_provider->SafeDownCast<gui::ViewProviderDocumentObjectTopoShape>();
+        }
+
+        if (auto it = styles.find(shape); it != styles.end() && it->second.has_color)
+        {
+            object->SolidColor.SetValue(it->second.color);
+        }
+
+        AMCAX::IndexSet<AMCAX::TopoShape> shapeFaces_;
+        AMCAX::TopoExplorerTool::MapShapes(shape, AMCAX::ShapeType::Face, shapeFaces_);
+
+        std::vector<std::pair<AMCAX::TopoShape, app::Color>> colors;
+        std::map<std::string, std::string> face_names;
+        std::map<std::string, double> face_opacities;
+        colors.reserve(shapeFaces_.size());
+
+        for (int j = 0; j < shapeFaces_.size(); ++j)
+        {
+            const AMCAX::TopoShape &sub_face = shapeFaces_[j];
+            auto it = styles.find(sub_face);
+            if (it == styles.end() || it->first.Type() != AMCAX::ShapeType::Face)
+                continue;
+
+            AMCAX::TopoShape placed_face = location.IsIdentity() ? it->first : it->first.Moved(location);
+            std::string face_id;
+            try
+            {
+                face_id = SubShapeIndex::GetInstance().GetSubElementId(object, placed_face).ToString();
+            }
+            catch (...)
+            {
+                continue;
+            }
+
+            auto const &style = it->second;
+            if (style.has_color)
+            {
+                colors.emplace_back(placed_face, style.color);
+                if (!face_id.empty())
+                    face_opacities[face_id] = style.color.a;
+            }
+            if (style.has_name && !face_id.empty())
+            {
+                face_names[face_id] = style.name;
+            }
+        }
+
+        object->SetFaceColors(colors);
+        object->SetFaceNames(face_names);
+        if (object_view_provider != nullptr)
+            object_view_provider->SetFaceOpacities(face_opacities);
+    }
+
+} // namespace Dev
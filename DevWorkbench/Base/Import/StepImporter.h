@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <App/Color.h>
+#include <Base/DevSetup.h>
+#include <step/STEPStyledProduct.hpp>
+#include <step/STEPProgress.hpp>
+#include <topology/TopoLocation.hpp>
+#include <topology/TopoShape.hpp>
+
+namespace app {
+class DocumentObjectTopoShape;
+}
+
+namespace AMCAX::STEP {
+class STEPStyledReader;
+}
+
+namespace Dev {
+
+/**
+ * @brief STEP导入器，负责把STEP文件中的产品转换为文档中的部件
+ *
+ * 流式模式下，读取在后台线程中进行，读取器每完成一个形状就通过STEPDataCallback通知，
+ * GUI线程在等待期间不断把已就绪的形状创建为DocumentObjectTopoShape，无需等待整个文件解析完成。
+ */
+class StepImporter
+{
+  public:
+    struct Options
+    {
+        // 是否流式创建部件，关闭时读取完成后再统一创建
+        bool streaming = true;
+        // 转换线程数，语义同STEPOptions::ReaderConcurrency，负数N表示hardware_concurrency() + N
+        std::int64_t translation_threads = -1;
+        // 是否并行网格化
+        bool concurrent_meshing = true;
+        // 网格化线程数，语义同STEPOptions::ReaderMeshingConcurrency
+        std::int64_t meshing_threads = -1;
+
+        // 从用户参数 BaseApp/Preferences/Mod/Dev/Import 中读取
+        static Options FromParameter();
+    };
+
+    explicit StepImporter(Options options = Options::FromParameter());
+    ~StepImporter();
+
+    bool Import(const std::filesystem::path& path);
+
+    // 由STEP样式解析出的颜色与名称
+    struct ShapeStyle
+    {
+        bool has_color = false;
+        app::Color color;
+        bool has_name = false;
+        std::string name;
+    };
+
+    // 以形状标识（TShape与位置，忽略方向）为键的样式索引，每个产品形状只建立一次，面查询为O(1)
+    using StyleIndex = std::unordered_map<AMCAX::TopoShape, ShapeStyle>;
+
+    static std::shared_ptr<const StyleIndex> BuildStyleIndex(const std::unordered_map<AMCAX::TopoShape, AMCAX::STEP::ShapeProperty>& pcs);
+
+  private:
+    // 产品在装配中的一次出现
+    struct Occurrence
+    {
+        std::string name;
+        AMCAX::TopoLocation location;
+    };
+
+    // 读取器通知已就绪的形状，形状与样式索引在回调线程中准备好，避免GUI线程与读取线程同时访问产品数据
+    struct ReadyShape
+    {
+        const AMCAX::STEP::STEPStyledProduct* product;
+        // 产品树中找不到该产品时使用的名称
+        std::string name;
+        AMCAX::TopoShape shape;
+        std::shared_ptr<const StyleIndex> styles;
+        bool isWireFrame;
+    };
+
+    bool ReadStreaming(AMCAX::STEP::STEPStyledReader& reader);
+    void CreateFlattened(const std::vector<std::shared_ptr<AMCAX::STEP::STEPStyledProduct>>& products);
+
+    void OnStepData(AMCAX::STEP::STEPDataEvent event, std::shared_ptr<AMCAX::STEP::STEPStyledProduct> product, std::size_t index);
+    void CollectOccurrences(const std::shared_ptr<AMCAX::STEP::STEPStyledProduct>& node, const AMCAX::TopoLocation& parent_location);
+    // final为true时读取已结束，仍找不到所在产品的形状以单位位置创建
+    void FlushReadyShapes(bool final = false);
+
+    // 待批量创建的部件，样式在对象创建后按产品坐标系下的形状应用
+    struct PendingPart
+    {
+        AMCAX::TopoShape local_shape;
+        AMCAX::TopoLocation location;
+        std::shared_ptr<const StyleIndex> styles;
+    };
+
+    void CreateParts(const std::string& name,
+                     const AMCAX::TopoShape& shape,
+                     const AMCAX::TopoLocation& location,
+                     const std::shared_ptr<const StyleIndex>& styles,
+                     bool isWireFrame);
+    void CommitParts();
+    void ApplyStyles(app::DocumentObjectTopoShape* object,
+                     const AMCAX::TopoShape& shape,
+                     const AMCAX::TopoLocation& location,
+                     const StyleIndex& styles);
+
+  private:
+    Options m_options;
+
+    std::mutex m_mutex;
+    AMCAX::STEP::STEPStyledReader* m_reader;
+    std::map<const AMCAX::STEP::STEPStyledProduct*, std::vector<Occurrence>> m_occurrences;
+    std::vector<ReadyShape> m_ready_shapes;
+    bool m_received_shapes;
+
+    std::vector<DevSetup::PartSpec> m_part_specs;
+    std::vector<PendingPart> m_pending_parts;
+    bool m_first_flush;
+};
+
+}  // namespace Dev
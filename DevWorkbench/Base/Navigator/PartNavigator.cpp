@@ -1,7 +1,10 @@
 
 
 #include "PartNavigator.h"
+#include "PartTreeView.h"
 #include "ShapeTree.h"
+#include <App/Application.h>
+#include <Base/Parameter.h>
 
 namespace Dev {
 
@@ -9,6 +12,7 @@ PartNavigator::PartNavigator()
   : Navigator("PartNavigator", tr("部件导航栏"))
   , tabWidget(nullptr)
   , shapebase(nullptr)
+  , partview(nullptr)
 {
 }
 
@@ -56,9 +60,18 @@ QWidget* PartNavigator::InitMainWidget(app::Document* doc)
                     }
         )");
 
-    shapebase = new ShapeTreeWidget(m_name, this);
-    shapebase->Init(doc);
-    tabWidget->addTab(shapebase, QIcon(), "");
+    if (IsVirtualTreeEnabled())
+    {
+        partview = new PartTreeView();
+        partview->Init(doc);
+        tabWidget->addTab(partview, QIcon(), "");
+    }
+    else
+    {
+        shapebase = new ShapeTreeWidget(m_name, this);
+        shapebase->Init(doc);
+        tabWidget->addTab(shapebase, QIcon(), "");
+    }
     tabWidget->setTabIcon(0, QIcon(":icon/left-bar/object-view.png"));
     tabWidget->setIconSize(QSize(27, 27));
     tabWidget->setTabToolTip(0, QObject::tr("对象视图"));
@@ -67,7 +80,18 @@ QWidget* PartNavigator::InitMainWidget(app::Document* doc)
 
 void PartNavigator::UpdateNavigator()
 {
-    shapebase->Refresh();
+    if (shapebase)
+        shapebase->Refresh();
+    if (partview)
+        partview->Refresh();
+}
+
+bool PartNavigator::IsVirtualTreeEnabled()
+{
+    auto grp = app::GetApplication().GetUserParameter().GetGroup("BaseApp/Preferences/Mod/Dev/Navigator");
+    if (!grp)
+        return false;
+    return grp->GetBool("VirtualTree", false);
 }
 
 }  // namespace Dev
\ No newline at end of file
@@ -6,6 +6,7 @@
 namespace Dev {
 
 class ShapeTreeWidget;
+class PartTreeView;
 
 class PartNavigator : public gui::Navigator
 {
@@ -19,12 +20,16 @@ class PartNavigator : public gui::Navigator
     }
     void UpdateNavigator();
 
+    // 用户参数 BaseApp/Preferences/Mod/Dev/Navigator/VirtualTree，开启后对象视图使用PartTreeView
+    static bool IsVirtualTreeEnabled();
+
   public:
     virtual QWidget* InitMainWidget(app::Document* doc) override;
 
   private:
     QTabWidget* tabWidget;
     ShapeTreeWidget* shapebase;
+    PartTreeView* partview;
     // PartLayerTree* layer_tree;
 };
 
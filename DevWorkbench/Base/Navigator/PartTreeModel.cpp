@@ -0,0 +1,422 @@
+#include "PartTreeModel.h"
+#include <App/DocumentObject.h>
+#include <Base/PartCollection.h>
+#include <Gui/Application.h>
+#include <Gui/ViewProvider/ViewProviderDocumentObject.h>
+#include <QTimer>
+#include <algorithm>
+#include <string_view>
+
+namespace Dev
+{
+    namespace
+    {
+        // 每次fetchMore加入的行数
+        constexpr int kFetchBatchSize = 1000;
+        // 待删除的连续区间超过该数量时整体重置模型，避免逐区间移动数组
+        constexpr std::size_t kMaxRemoveRanges = 16;
+
+        // internalId：根节点行为ROOT_ID，部件行为PART_ID
+        constexpr quintptr ROOT_ID = 0;
+        constexpr quintptr PART_ID = 1;
+
+        // 所有行共用的图标，只从资源加载一次
+        const QIcon &VisibleIcon()
+        {
+            static const QIcon icon(":icon/base/icon_visiable.png");
+            return icon;
+        }
+
+        const QIcon &InvisibleIcon()
+        {
+            static const QIcon icon(":icon/base/icon_invisiable.png");
+            return icon;
+        }
+    } // namespace
+
+    PartTreeModel::PartTreeModel(QObject *parent)
+        : QAbstractItemModel(parent), m_fetched(0), m_removed(0)
+    {
+        m_change_timer = new QTimer(this);
+        m_change_timer->setSingleShot(true);
+        m_change_timer->setInterval(0);
+        connect(m_change_timer, &QTimer::timeout, this, [this]()
+                { FlushChanges(); });
+    }
+
+    PartTreeModel::~PartTreeModel()
+    {
+        Disconnect();
+    }
+
+    void PartTreeModel::Disconnect()
+    {
+        if (connectCreateObject.connected())
+            connectCreateObject.disconnect();
+        if (connectCreateObjects.connected())
+            connectCreateObjects.disconnect();
+        if (connectDeleteObject.connected())
+            connectDeleteObject.disconnect();
+        if (connectChangedObject.connected())
+            connectChangedObject.disconnect();
+        if (connectChangedObjects.connected())
+            connectChangedObjects.disconnect();
+    }
+
+    void PartTreeModel::Reset(PartCollection *collection)
+    {
+        beginResetModel();
+        Disconnect();
+        m_parts.clear();
+        m_rows.clear();
+        m_changed.clear();
+        m_removed = 0;
+        m_fetched = 0;
+        if (collection)
+        {
+            auto parts = collection->PartList();
+            m_parts.assign(parts.begin(), parts.end());
+            ApplySortList(collection->GetSortList());
+            RebuildRows();
+
+            connectCreateObject = collection->SignalNewObject.connect([this](const app::DocumentObject &obj)
+                                                                      { OnCreateObject(obj); });
+            connectCreateObjects = collection->SignalNewObjects.connect([this](const std::vector<const app::DocumentObject *> &objs)
+                                                                        { OnCreateObjects(objs); });
+            connectDeleteObject = collection->SignalDeletedObject.connect([this](const app::DocumentObject &obj)
+                                                                          { OnDeleteObject(obj); });
+            connectChangedObject = collection->SignalObjectPropertyChanged.connect([this](const app::DocumentObject &obj, const app::Property &)
+                                                                                   { OnChangeObject(obj); });
+            connectChangedObjects = collection->SignalObjectsChanged.connect([this](const std::vector<const app::DocumentObject *> &objs)
+                                                                             { OnChangeObjects(objs); });
+        }
+        endResetModel();
+    }
+
+    void PartTreeModel::ApplySortList(const std::map<std::string, std::vector<std::string>> &sort_list)
+    {
+        // 根节点下的顺序记录在键""中，不在列表中的部件保持原有顺序排在最后
+        auto it = sort_list.find("");
+        if (it == sort_list.end() || it->second.empty())
+            return;
+        std::unordered_map<std::string_view, std::size_t> order;
+        order.reserve(it->second.size());
+        for (std::size_t i = 0; i < it->second.size(); ++i)
+            order.emplace(it->second[i], i);
+        auto rank = [&](const app::DocumentObject *obj)
+        {
+            auto found = order.find(obj->GetNameInDocument());
+            return found == order.end() ? order.size() : found->second;
+        };
+        std::stable_sort(m_parts.begin(), m_parts.end(), [&](const app::DocumentObject *a, const app::DocumentObject *b)
+                         { return rank(a) < rank(b); });
+    }
+
+    void PartTreeModel::RebuildRows()
+    {
+        m_rows.clear();
+        m_rows.reserve(m_parts.size());
+        for (int row = 0; row < static_cast<int>(m_parts.size()); ++row)
+            m_rows[m_parts[row]] = row;
+    }
+
+    const app::DocumentObject *PartTreeModel::GetObject(const QModelIndex &index) const
+    {
+        if (!index.isValid() || index.internalId() != PART_ID || index.row() >= m_fetched)
+            return nullptr;
+        return m_parts[index.row()];
+    }
+
+    QModelIndex PartTreeModel::IndexOf(const app::DocumentObject *obj, int column) const
+    {
+        auto it = m_rows.find(obj);
+        if (it == m_rows.end() || it->second >= m_fetched)
+            return QModelIndex();
+        return createIndex(it->second, column, PART_ID);
+    }
+
+    QModelIndex PartTreeModel::LoadIndex(const app::DocumentObject *obj, int column)
+    {
+        auto it = m_rows.find(obj);
+        if (it == m_rows.end())
+            return QModelIndex();
+        if (it->second >= m_fetched)
+        {
+            int last = std::min(static_cast<int>(m_parts.size()), (it->second / kFetchBatchSize + 1) * kFetchBatchSize) - 1;
+            beginInsertRows(RootIndex(), m_fetched, last);
+            m_fetched = last + 1;
+            endInsertRows();
+        }
+        return createIndex(it->second, column, PART_ID);
+    }
+
+    QModelIndex PartTreeModel::RootIndex() const
+    {
+        return createIndex(0, COLUMN_NAME, ROOT_ID);
+    }
+
+    gui::ViewProviderDocumentObject *PartTreeModel::GetViewProvider(const app::DocumentObject *obj)
+    {
+        if (!obj)
+            return nullptr;
+        return dynamic_cast<gui::ViewProviderDocumentObject *>(gui::GetGuiApplication()->GetViewProvider(obj));
+    }
+
+    QModelIndex PartTreeModel::index(int row, int column, const QModelIndex &parent) const
+    {
+        if (column < 0 || column >= COLUMN_COUNT || row < 0)
+            return QModelIndex();
+        if (!parent.isValid())
+            return row == 0 ? createIndex(0, column, ROOT_ID) : QModelIndex();
+        if (parent.internalId() == ROOT_ID && row < m_fetched)
+            return createIndex(row, column, PART_ID);
+        return QModelIndex();
+    }
+
+    QModelIndex PartTreeModel::parent(const QModelIndex &index) const
+    {
+        if (!index.isValid() || index.internalId() == ROOT_ID)
+            return QModelIndex();
+        return RootIndex();
+    }
+
+    int PartTreeModel::rowCount(const QModelIndex &parent) const
+    {
+        if (!parent.isValid())
+            return 1;
+        if (parent.internalId() == ROOT_ID && parent.column() == COLUMN_NAME)
+            return m_fetched;
+        return 0;
+    }
+
+    int PartTreeModel::columnCount(const QModelIndex &) const
+    {
+        return COLUMN_COUNT;
+    }
+
+    bool PartTreeModel::hasChildren(const QModelIndex &parent) const
+    {
+        if (!parent.isValid())
+            return true;
+        return parent.internalId() == ROOT_ID && parent.column() == COLUMN_NAME && !m_parts.empty();
+    }
+
+    bool PartTreeModel::canFetchMore(const QModelIndex &parent) const
+    {
+        return parent.isValid() && parent.internalId() == ROOT_ID && m_fetched < static_cast<int>(m_parts.size());
+    }
+
+    void PartTreeModel::fetchMore(const QModelIndex &parent)
+    {
+        if (!canFetchMore(parent))
+            return;
+        int count = std::min(kFetchBatchSize, static_cast<int>(m_parts.size()) - m_fetched);
+        beginInsertRows(RootIndex(), m_fetched, m_fetched + count - 1);
+        m_fetched += count;
+        endInsertRows();
+    }
+
+    QVariant PartTreeModel::data(const QModelIndex &index, int role) const
+    {
+        if (!index.isValid())
+            return QVariant();
+
+        if (index.internalId() == ROOT_ID)
+        {
+            if (role == Qt::DisplayRole && index.column() == COLUMN_NAME)
+                return tr("部件");
+            return QVariant();
+        }
+
+        auto obj = GetObject(index);
+        if (!obj)
+            return QVariant();
+
+        switch (role)
+        {
+        case Qt::DisplayRole:
+        case Qt::ToolTipRole:
+            if (index.column() == COLUMN_NAME)
+                return QString::fromUtf8(obj->Label.GetString());
+            break;
+        case Qt::DecorationRole:
+            if (index.column() == COLUMN_VISIABLE)
+            {
+                auto view = GetViewProvider(obj);
+                if (view)
+                    return view->Visibility.GetValue() ? VisibleIcon() : InvisibleIcon();
+            }
+            break;
+        default:
+            break;
+        }
+        return QVariant();
+    }
+
+    QVariant PartTreeModel::headerData(int section, Qt::Orientation orientation, int role) const
+    {
+        if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+            return QVariant();
+        switch (section)
+        {
+        case COLUMN_NAME:
+            return tr("名称");
+        case COLUMN_VISIABLE:
+            return tr("可见");
+        default:
+            return QVariant();
+        }
+    }
+
+    Qt::ItemFlags PartTreeModel::flags(const QModelIndex &index) const
+    {
+        if (!index.isValid())
+            return Qt::NoItemFlags;
+        if (index.internalId() == ROOT_ID)
+            return Qt::ItemIsEnabled;
+        return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+    }
+
+    void PartTreeModel::OnCreateObject(const app::DocumentObject &obj)
+    {
+        AppendObjects({&obj});
+    }
+
+    void PartTreeModel::OnCreateObjects(const std::vector<const app::DocumentObject *> &objs)
+    {
+        AppendObjects(objs);
+    }
+
+    void PartTreeModel::AppendObjects(const std::vector<const app::DocumentObject *> &objs)
+    {
+        if (objs.empty())
+            return;
+
+        bool was_empty = m_parts.empty();
+        // 已全部加载时新行直接加入模型，否则等待fetchMore
+        bool fully_fetched = m_fetched == static_cast<int>(m_parts.size());
+        int first = static_cast<int>(m_parts.size());
+        int count = std::min(static_cast<int>(objs.size()), fully_fetched ? kFetchBatchSize : 0);
+
+        if (count > 0)
+            beginInsertRows(RootIndex(), first, first + count - 1);
+        for (auto obj : objs)
+        {
+            m_rows[obj] = static_cast<int>(m_parts.size());
+            m_parts.push_back(obj);
+        }
+        if (count > 0)
+        {
+            m_fetched += count;
+            endInsertRows();
+        }
+        else if (was_empty)
+        {
+            // 根节点由无子节点变为有子节点，通知视图显示展开标记
+            emit dataChanged(RootIndex(), RootIndex());
+        }
+    }
+
+    void PartTreeModel::OnDeleteObject(const app::DocumentObject &obj)
+    {
+        m_changed.erase(&obj);
+        auto it = m_rows.find(&obj);
+        if (it == m_rows.end())
+            return;
+
+        // 先留空行，连续删除在下一次事件循环中统一移除，行号只重建一次
+        m_parts[it->second] = nullptr;
+        m_rows.erase(it);
+        ++m_removed;
+        if (!m_change_timer->isActive())
+            m_change_timer->start();
+    }
+
+    void PartTreeModel::CompactRows()
+    {
+        if (m_removed == 0)
+            return;
+        m_removed = 0;
+
+        // 已加载行中的空行按连续区间收集
+        std::vector<std::pair<int, int>> ranges;
+        for (int row = 0; row < m_fetched; ++row)
+        {
+            if (m_parts[row])
+                continue;
+            if (!ranges.empty() && ranges.back().second == row - 1)
+                ranges.back().second = row;
+            else
+                ranges.emplace_back(row, row);
+        }
+
+        auto is_removed = [](const app::DocumentObject *obj)
+        { return obj == nullptr; };
+        if (ranges.size() > kMaxRemoveRanges)
+        {
+            beginResetModel();
+            for (auto const &range : ranges)
+                m_fetched -= range.second - range.first + 1;
+            m_parts.erase(std::remove_if(m_parts.begin(), m_parts.end(), is_removed), m_parts.end());
+            RebuildRows();
+            endResetModel();
+            return;
+        }
+
+        // 从后向前移除，前面区间的行号不受影响
+        for (auto range = ranges.rbegin(); range != ranges.rend(); ++range)
+        {
+            beginRemoveRows(RootIndex(), range->first, range->second);
+            m_parts.erase(m_parts.begin() + range->first, m_parts.begin() + range->second + 1);
+            m_fetched -= range->second - range->first + 1;
+            endRemoveRows();
+        }
+        // 剩余的空行都在未加载的部分
+        m_parts.erase(std::remove_if(m_parts.begin() + m_fetched, m_parts.end(), is_removed), m_parts.end());
+        RebuildRows();
+    }
+
+    void PartTreeModel::OnChangeObject(const app::DocumentObject &obj)
+    {
+        m_changed.insert(&obj);
+        if (!m_change_timer->isActive())
+            m_change_timer->start();
+    }
+
+    void PartTreeModel::OnChangeObjects(const std::vector<const app::DocumentObject *> &objs)
+    {
+        m_changed.insert(objs.begin(), objs.end());
+        if (!m_changed.empty() && !m_change_timer->isActive())
+            m_change_timer->start();
+    }
+
+    void PartTreeModel::FlushChanges()
+    {
+        CompactRows();
+        if (m_changed.empty())
+            return;
+
+        // 只通知已加载的行，按连续区间合并为尽量少的dataChanged
+        std::vector<int> rows;
+        rows.reserve(m_changed.size());
+        for (auto obj : m_changed)
+        {
+            auto it = m_rows.find(obj);
+            if (it != m_rows.end() && it->second < m_fetched)
+                rows.push_back(it->second);
+        }
+        m_changed.clear();
+        std::sort(rows.begin(), rows.end());
+
+        std::size_t begin = 0;
+        while (begin < rows.size())
+        {
+            std::size_t end = begin + 1;
+            while (end < rows.size() && rows[end] == rows[end - 1] + 1)
+                ++end;
+            emit dataChanged(createIndex(rows[begin], COLUMN_NAME, PART_ID), createIndex(rows[end - 1], COLUMN_COUNT - 1, PART_ID));
+            begin = end;
+        }
+    }
+
+} // namespace Dev
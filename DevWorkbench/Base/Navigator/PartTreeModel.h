@@ -0,0 +1,105 @@
+#pragma once
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <QAbstractItemModel>
+#include <QIcon>
+#include <boost/signals2.hpp>
+
+class QTimer;
+
+namespace app {
+class DocumentObject;
+}
+
+namespace gui {
+class ViewProviderDocumentObject;
+}
+
+namespace Dev {
+
+class PartCollection;
+
+/**
+ * @brief 部件导航栏的虚拟化数据模型
+ *
+ * 不为部件创建条目对象，显示所需的数据在视图请求时从文档对象读取。
+ * 部件按PartCollection的排序列表排列，按批次通过fetchMore加入模型，展开根节点时只加载首批；
+ * 新建通过PartCollection的信号逐行插入。删除先把行置空，与属性变化一起在下一次事件循环中处理：
+ * 空行按连续区间移除（区间过多时重置模型），行号只重建一次，属性变化合并后发出dataChanged。
+ */
+class PartTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+  public:
+    enum Column
+    {
+        COLUMN_NAME = 0, /** 名称 */
+        COLUMN_VISIABLE, /** 可见 */
+        COLUMN_COUNT
+    };
+
+    explicit PartTreeModel(QObject* parent = nullptr);
+    ~PartTreeModel() override;
+
+    // 从PartCollection重新读取部件列表
+    void Reset(PartCollection* collection);
+
+    const app::DocumentObject* GetObject(const QModelIndex& index) const;
+    QModelIndex IndexOf(const app::DocumentObject* obj, int column = COLUMN_NAME) const;
+    // 部件所在行尚未加载时先加载到该行
+    QModelIndex LoadIndex(const app::DocumentObject* obj, int column = COLUMN_NAME);
+    QModelIndex RootIndex() const;
+    static gui::ViewProviderDocumentObject* GetViewProvider(const app::DocumentObject* obj);
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& index) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+    bool hasChildren(const QModelIndex& parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+  private:
+    void OnCreateObject(const app::DocumentObject& obj);
+    void OnCreateObjects(const std::vector<const app::DocumentObject*>& objs);
+    void OnDeleteObject(const app::DocumentObject& obj);
+    void OnChangeObject(const app::DocumentObject& obj);
+    void OnChangeObjects(const std::vector<const app::DocumentObject*>& objs);
+
+    void AppendObjects(const std::vector<const app::DocumentObject*>& objs);
+    void ApplySortList(const std::map<std::string, std::vector<std::string>>& sort_list);
+    void RebuildRows();
+    // 移除已删除部件留下的空行
+    void CompactRows();
+    void FlushChanges();
+    void Disconnect();
+
+  private:
+    // 已删除的部件在CompactRows之前为nullptr
+    std::vector<const app::DocumentObject*> m_parts;
+    // 部件到行号
+    std::unordered_map<const app::DocumentObject*, int> m_rows;
+    // 已加入模型的行数，其余等待fetchMore
+    int m_fetched;
+    // 尚未移除的空行数
+    int m_removed;
+
+    std::unordered_set<const app::DocumentObject*> m_changed;
+    QTimer* m_change_timer;
+
+    using Connection = boost::signals2::connection;
+    Connection connectCreateObject;
+    Connection connectCreateObjects;
+    Connection connectDeleteObject;
+    Connection connectChangedObject;
+    Connection connectChangedObjects;
+};
+
+}  // namespace Dev
@@ -0,0 +1,169 @@
+#include "PartTreeView.h"
+#include "PartTreeModel.h"
+#include <App/Application.h>
+#include <App/Document.h>
+#include <App/DocumentObject.h>
+#include <Base/DevSetup.h>
+#include <Base/PartCollection.h>
+#include <Gui/Command/Action.h>
+#include <Gui/Command/Command.h>
+#include <Gui/Selection/Selection.h>
+#include <Gui/ViewProvider/ViewProviderDocumentObject.h>
+#include <QHeaderView>
+#include <QMenu>
+#include <QMouseEvent>
+
+namespace Dev
+{
+    PartTreeView::PartTreeView(QWidget *parent)
+        : QTreeView(parent), gui::SelectionObserver(true), m_model(new PartTreeModel(this)), m_doc(nullptr), m_syncing(false)
+    {
+        // 固定行高后视图无需逐行计算尺寸，滚动与布局只与可见行数有关
+        setUniformRowHeights(true);
+        setModel(m_model);
+        setSelectionMode(QAbstractItemView::ExtendedSelection);
+        setContextMenuPolicy(Qt::CustomContextMenu);
+        header()->setStretchLastSection(false);
+        header()->setSectionResizeMode(PartTreeModel::COLUMN_NAME, QHeaderView::Stretch);
+        header()->setSectionResizeMode(PartTreeModel::COLUMN_VISIABLE, QHeaderView::ResizeToContents);
+
+        connect(this, &QTreeView::clicked, this, &PartTreeView::OnClicked);
+        connect(selectionModel(), &QItemSelectionModel::selectionChanged, this, [this]()
+                { OnTreeSelectionChanged(); });
+        // 删除区间过多时模型整体重置，重新展开根节点
+        connect(m_model, &QAbstractItemModel::modelReset, this, [this]()
+                { expand(m_model->RootIndex()); });
+        connect(this, &QWidget::customContextMenuRequested, this, &PartTreeView::OnCustomContextMenu);
+    }
+
+    PartTreeView::~PartTreeView()
+    {
+    }
+
+    void PartTreeView::Init(app::Document *doc)
+    {
+        m_doc = doc;
+        Refresh();
+    }
+
+    void PartTreeView::Refresh()
+    {
+        auto setup = DevSetup::GetCurDevSetup();
+        m_model->Reset(setup ? setup->DevPartCollection() : nullptr);
+        // 只展开根节点，部件行由视图滚动时按需加载
+        expand(m_model->RootIndex());
+    }
+
+    void PartTreeView::OnClicked(const QModelIndex &index)
+    {
+        if (index.column() != PartTreeModel::COLUMN_VISIABLE)
+            return;
+        auto view = PartTreeModel::GetViewProvider(m_model->GetObject(index));
+        if (!view)
+            return;
+        bool visible = view->Visibility.GetValue();
+
+        // 点击的行在多选范围内时，所有选中的部件一起切换
+        std::vector<gui::ViewProviderDocumentObject *> targets;
+        if (selectionModel()->isSelected(index.siblingAtColumn(PartTreeModel::COLUMN_NAME)))
+        {
+            for (auto const &selected : selectionModel()->selectedRows(PartTreeModel::COLUMN_NAME))
+            {
+                if (auto target = PartTreeModel::GetViewProvider(m_model->GetObject(selected)))
+                    targets.push_back(target);
+            }
+        }
+        if (targets.empty())
+            targets.push_back(view);
+
+        if (visible)
+            app::OpenCommand(tr("隐藏").toStdString());
+        else
+            app::OpenCommand(tr("显示").toStdString());
+        {
+            auto setup = DevSetup::GetCurDevSetup();
+            PartCollection::ScopedBatch batch(setup ? setup->DevPartCollection() : nullptr);
+            for (auto target : targets)
+                target->Visibility.SetValue(!visible);
+        }
+        app::CommitCommand();
+        // 视图提供者的可见性变化不一定经过文档对象的属性信号，直接重绘
+        viewport()->update();
+    }
+
+    void PartTreeView::OnTreeSelectionChanged()
+    {
+        if (!m_doc || m_syncing)
+            return;
+        std::vector<std::string> names;
+        for (auto const &index : selectionModel()->selectedRows(PartTreeModel::COLUMN_NAME))
+        {
+            if (auto obj = m_model->GetObject(index))
+                names.emplace_back(obj->GetNameInDocument());
+        }
+        m_syncing = true;
+        gui::Selection().ClearSelection();
+        if (!names.empty())
+            gui::Selection().AddSelectings(m_doc->GetName(), names);
+        m_syncing = false;
+    }
+
+    void PartTreeView::OnSelectionChanged(const gui::SelectionChanges &msg)
+    {
+        if (!m_doc || m_syncing)
+            return;
+
+        QItemSelectionModel::SelectionFlags flags;
+        switch (msg.m_type)
+        {
+        case gui::SelectionChanges::AddSelecting:
+            flags = QItemSelectionModel::Select | QItemSelectionModel::Rows;
+            break;
+        case gui::SelectionChanges::RemoveSelecting:
+            flags = QItemSelectionModel::Deselect | QItemSelectionModel::Rows;
+            break;
+        case gui::SelectionChanges::ClearSelecting:
+            m_syncing = true;
+            selectionModel()->clearSelection();
+            m_syncing = false;
+            return;
+        default:
+            return;
+        }
+
+        if (msg.document_name != m_doc->GetName())
+            return;
+        auto obj = m_doc->GetObject(msg.object_name);
+        if (!obj)
+            return;
+        auto index = m_model->LoadIndex(obj);
+        if (!index.isValid())
+            return;
+
+        m_syncing = true;
+        selectionModel()->select(index, flags);
+        if (flags & QItemSelectionModel::Select)
+            scrollTo(index);
+        m_syncing = false;
+    }
+
+    void PartTreeView::OnCustomContextMenu(const QPoint &pos)
+    {
+        if (!m_model->GetObject(indexAt(pos)))
+            return;
+        auto command = gui::CommandManager::GetInstance().GetCommandByName("Std_Delete");
+        if (!command || !command->GetAction())
+            return;
+
+        QMenu menu(this);
+        menu.addAction(command->GetAction()->GetAction());
+        menu.exec(QCursor::pos());
+    }
+
+    void PartTreeView::mouseDoubleClickEvent(QMouseEvent *event)
+    {
+        if (m_model->GetObject(indexAt(event->pos())))
+            gui::CommandManager::GetInstance().RunCommandByName("Dev_EditDisplay");
+    }
+
+} // namespace Dev
@@ -0,0 +1,48 @@
+#pragma once
+#include <QTreeView>
+#include <Gui/Selection/Selection.h>
+
+namespace app {
+class Document;
+}
+
+namespace Dev {
+
+class PartTreeModel;
+
+/**
+ * @brief 基于PartTreeModel的部件树视图
+ *
+ * 行高固定，只绘制可见的行，适用于部件数量很大的文档。
+ * 点击可见列切换显示状态，选择与gui::Selection双向同步，双击编辑显示属性。
+ */
+class PartTreeView : public QTreeView, public gui::SelectionObserver
+{
+    Q_OBJECT
+
+  public:
+    explicit PartTreeView(QWidget* parent = nullptr);
+    ~PartTreeView() override;
+
+    void Init(app::Document* doc);
+    void Refresh();
+
+  protected:
+    void mouseDoubleClickEvent(QMouseEvent* event) override;
+
+  private:
+    void OnClicked(const QModelIndex& index);
+    // 树中的选择同步到gui::Selection
+    void OnTreeSelectionChanged();
+    // 视图中的选择同步到树
+    void OnSelectionChanged(const gui::SelectionChanges& msg) override;
+    void OnCustomContextMenu(const QPoint& pos);
+
+  private:
+    PartTreeModel* m_model;
+    app::Document* m_doc;
+    // 同步选择期间忽略另一方的回调
+    bool m_syncing;
+};
+
+}  // namespace Dev
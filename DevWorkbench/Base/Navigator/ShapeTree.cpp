@@ -11,6 +11,8 @@
 #include <App/PropertyContainer.h>
 #include <Gui/MainWindow.h>
 #include <Gui/Command/WorkbenchCommand.h>
+#include <QTimer>
+#include <algorithm>
 
 namespace Dev
 {
@@ -18,19 +20,30 @@ namespace Dev
         : gui::TreeWidget(name, parent), m_nav(parent)
     {
         InitRoot();
+        m_update_timer = new QTimer(this);
+        m_update_timer->setSingleShot(true);
+        m_update_timer->setInterval(0);
+        connect(m_update_timer, &QTimer::timeout, this, [this]()
+                { FlushUpdates(); });
         connectCreateObject = Dev::DevSetup::GetCurDevSetup()->DevPartCollection()->SignalNewObject.connect(boost::bind(&ShapeTreeWidget::OnCreateObject, this, boost::placeholders::_1));
+        connectCreateObjects = Dev::DevSetup::GetCurDevSetup()->DevPartCollection()->SignalNewObjects.connect(boost::bind(&ShapeTreeWidget::OnCreateObjects, this, boost::placeholders::_1));
         connectDeleteObject = Dev::DevSetup::GetCurDevSetup()->DevPartCollection()->SignalDeletedObject.connect(boost::bind(&ShapeTreeWidget::OnDeleteObject, this, boost::placeholders::_1));
         connectChangedObject = Dev::DevSetup::GetCurDevSetup()->DevPartCollection()->SignalObjectPropertyChanged.connect(boost::bind(&ShapeTreeWidget::OnChangeObject, this, boost::placeholders::_1, boost::placeholders::_2));
+        connectChangedObjects = Dev::DevSetup::GetCurDevSetup()->DevPartCollection()->SignalObjectsChanged.connect(boost::bind(&ShapeTreeWidget::OnChangeObjects, this, boost::placeholders::_1));
     }
 
     ShapeTreeWidget::~ShapeTreeWidget()
     {
         if (connectCreateObject.connected())
             connectCreateObject.disconnect();
+        if (connectCreateObjects.connected())
+            connectCreateObjects.disconnect();
         if (connectDeleteObject.connected())
             connectDeleteObject.disconnect();
         if (connectChangedObject.connected())
             connectChangedObject.disconnect();
+        if (connectChangedObjects.connected())
+            connectChangedObjects.disconnect();
     }
 
     void ShapeTreeWidget::InitTree(app::Document *doc)
@@ -38,6 +51,9 @@ namespace Dev
         if (!doc)
             return;
         m_doc = doc;
+        m_items.clear();
+        m_dirty_objects.clear();
+        m_dirty_object_set.clear();
         while (Root()->childCount() > 0)
         {
             QTreeWidgetItem *child = Root()->takeChild(0); // 取出并移除第一个子节点
@@ -49,6 +65,7 @@ namespace Dev
             gui::DocumentObjectItem *item = new gui::DocumentObjectItem(obj, Root());
             UpdateItem(item);
             Root()->addChild(item);
+            m_items[obj] = item;
         }
         this->expandAll();
     }
@@ -64,7 +81,10 @@ namespace Dev
             QString name = QString::fromUtf8(obj->Label.GetString());
             item->setText(COLUMN_NAME, name);
             bool visiable = item->GetViewProvider()->Visibility.GetValue();
-            item->setIcon(COLUMN_VISIABLE, visiable ? QIcon(":icon/base/icon_visiable.png") : QIcon(":icon/base/icon_invisiable.png"));
+            // 图标只加载一次，所有条目共用
+            static const QIcon visible_icon(":icon/base/icon_visiable.png");
+            static const QIcon invisible_icon(":icon/base/icon_invisiable.png");
+            item->setIcon(COLUMN_VISIABLE, visiable ? visible_icon : invisible_icon);
         }
         return item;
     }
@@ -107,31 +127,90 @@ namespace Dev
         gui::TreeWidget::dropEvent(event);
     }
 
+    // PartCollection的信号已按部件类型过滤
     void ShapeTreeWidget::OnCreateObject(const app::DocumentObject &obj)
     {
-        if (!obj.GetClassTypePolymorphic().IsSubTypeOf(app::DocumentObjectTopoShape::GetClassType()))
-            return;
         gui::DocumentObjectItem *item = new gui::DocumentObjectItem(&obj, Root());
         UpdateItem(item);
         Root()->addChild(item);
+        m_items[&obj] = item;
     }
 
-    void ShapeTreeWidget::OnDeleteObject(const app::DocumentObject &obj)
+    void ShapeTreeWidget::OnCreateObjects(const std::vector<const app::DocumentObject *> &objs)
     {
-        if (!obj.GetClassTypePolymorphic().IsSubTypeOf(app::DocumentObjectTopoShape::GetClassType()))
+        // 批量创建时一次性插入，避免逐项触发布局与重绘
+        QList<QTreeWidgetItem *> items;
+        items.reserve(static_cast<qsizetype>(objs.size()));
+        for (auto obj : objs)
+        {
+            gui::DocumentObjectItem *item = new gui::DocumentObjectItem(obj);
+            UpdateItem(item);
+            items.append(item);
+            m_items[obj] = item;
+        }
+        if (items.isEmpty())
             return;
-        auto item = FindItem(Root(), &obj);
+
+        setUpdatesEnabled(false);
+        Root()->addChildren(items);
+        setUpdatesEnabled(true);
+    }
+
+    void ShapeTreeWidget::OnDeleteObject(const app::DocumentObject &obj)
+    {
+        if (m_dirty_object_set.erase(&obj))
+            m_dirty_objects.erase(std::remove(m_dirty_objects.begin(), m_dirty_objects.end(), &obj), m_dirty_objects.end());
+
+        auto item = FindPartItem(&obj);
+        m_items.erase(&obj);
         if (item)
+        {
             item->parent()->removeChild(item);
+            delete item;
+        }
     }
 
     void ShapeTreeWidget::OnChangeObject(const app::DocumentObject &obj, const app::Property &)
     {
-        if (!obj.GetClassTypePolymorphic().IsSubTypeOf(app::DocumentObjectTopoShape::GetClassType()))
+        ScheduleUpdate(&obj);
+    }
+
+    void ShapeTreeWidget::OnChangeObjects(const std::vector<const app::DocumentObject *> &objs)
+    {
+        for (auto obj : objs)
+            ScheduleUpdate(obj);
+    }
+
+    void ShapeTreeWidget::ScheduleUpdate(const app::DocumentObject *obj)
+    {
+        if (m_dirty_object_set.insert(obj).second)
+            m_dirty_objects.push_back(obj);
+        if (!m_update_timer->isActive())
+            m_update_timer->start();
+    }
+
+    void ShapeTreeWidget::FlushUpdates()
+    {
+        std::vector<const app::DocumentObject *> objects;
+        objects.swap(m_dirty_objects);
+        m_dirty_object_set.clear();
+        if (objects.empty())
             return;
-        auto item = FindItem(Root(), &obj);
-        if (item)
-            UpdateItem(item);
+
+        setUpdatesEnabled(false);
+        for (auto obj : objects)
+        {
+            auto item = FindPartItem(obj);
+            if (item)
+                UpdateItem(item);
+        }
+        setUpdatesEnabled(true);
+    }
+
+    gui::DocumentObjectItem *ShapeTreeWidget::FindPartItem(const app::DocumentObject *obj) const
+    {
+        auto it = m_items.find(obj);
+        return it == m_items.end() ? nullptr : it->second;
     }
 
     void ShapeTreeWidget::OnItemClick(QTreeWidgetItem *item, int column)
@@ -143,13 +222,34 @@ namespace Dev
                 return;
             auto view = obj_item->GetViewProvider();
             bool visible = view->Visibility.GetValue();
+
+            // 点击的条目在多选范围内时，所有选中的部件一起切换
+            QList<gui::DocumentObjectItem *> targets;
+            if (item->isSelected())
+            {
+                for (auto selected : selectedItems())
+                {
+                    auto selected_item = dynamic_cast<gui::DocumentObjectItem *>(selected);
+                    if (selected_item && selected_item->Data()->type == PART && selected_item->GetViewProvider())
+                        targets.append(selected_item);
+                }
+            }
+            if (targets.isEmpty())
+                targets.append(obj_item);
+
             if (visible)
                 app::OpenCommand(ShapeTreeWidget::tr("隐藏").toStdString());
             else
                 app::OpenCommand(ShapeTreeWidget::tr("显示").toStdString());
-            view->Visibility.SetValue(!visible);
+            {
+                PartCollection::ScopedBatch batch(DevSetup::GetCurDevSetup()->DevPartCollection());
+                for (auto target : targets)
+                {
+                    target->GetViewProvider()->Visibility.SetValue(!visible);
+                    ScheduleUpdate(target->GetObject());
+                }
+            }
             app::CommitCommand();
-            m_nav->UpdateNavigator();
         }
     }
 
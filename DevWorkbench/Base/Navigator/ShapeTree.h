@@ -1,6 +1,11 @@
 #pragma once
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <Gui/Workbench/Navigator/Tree.h>
 
+class QTimer;
+
 namespace Dev {
 
 enum ShapeTreeItemType
@@ -29,8 +34,15 @@ class ShapeTreeWidget : public gui::TreeWidget
 
   private:
     void OnCreateObject(const app::DocumentObject&);
+    void OnCreateObjects(const std::vector<const app::DocumentObject*>&);
     void OnDeleteObject(const app::DocumentObject&);
     void OnChangeObject(const app::DocumentObject&, const app::Property&);
+    void OnChangeObjects(const std::vector<const app::DocumentObject*>&);
+
+    // 属性变化只记录对象，在下一次事件循环中统一刷新
+    void ScheduleUpdate(const app::DocumentObject* obj);
+    void FlushUpdates();
+    gui::DocumentObjectItem* FindPartItem(const app::DocumentObject* obj) const;
 
     virtual void OnItemClick(QTreeWidgetItem* item, int column) override;
     void mouseDoubleClickEvent(QMouseEvent* event) override;
@@ -45,9 +57,16 @@ class ShapeTreeWidget : public gui::TreeWidget
   private:
     PartNavigator* m_nav;
     Connection connectCreateObject;
+    Connection connectCreateObjects;
     Connection connectDeleteObject;
     Connection connectChangedObject;
+    Connection connectChangedObjects;
     gui::DocumentObjectItem* m_root;
+    // 部件对象到条目，代替逐项遍历的FindItem
+    std::unordered_map<const app::DocumentObject*, gui::DocumentObjectItem*> m_items;
+    std::vector<const app::DocumentObject*> m_dirty_objects;
+    std::unordered_set<const app::DocumentObject*> m_dirty_object_set;
+    QTimer* m_update_timer;
     enum ViewColumn
     {
         COLUMN_NAME = 0, /** 名称 */
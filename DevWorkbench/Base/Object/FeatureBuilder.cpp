@@ -0,0 +1,127 @@
+#include "FeatureBuilder.h"
+#include "DevObject.h"
+#include "FeatureCache.h"
+#include <App/Properties/PropertyFloat.h>
+#include <App/Properties/PropertyTopoShape.h>
+#include <App/Properties/PropertyVector.h>
+#include <geometry/Geom3BSplineSurface.hpp>
+#include <geometry/Geom3Curve.hpp>
+#include <modeling/MakeBox.hpp>
+#include <modeling/MakeFace.hpp>
+#include <nurbs/NURBSAPIGetGeometry.hpp>
+#include <nurbs/NURBSAPILoft.hpp>
+#include <nurbs/NURBSCurveSection.hpp>
+#include <topology/TopoFace.hpp>
+
+namespace Dev
+{
+    namespace
+    {
+        AMCAX::TopoShape GetShapeProperty(const DevObject *object, std::string_view name)
+        {
+            auto prop = object->GetDynamicPropertyByName(name);
+            if (!prop)
+                return AMCAX::TopoShape();
+            auto shape = prop->SafeDownCast<app::PropertyTopoShape>();
+            return shape ? shape->GetValue() : AMCAX::TopoShape();
+        }
+    } // namespace
+
+    FeatureBuilder::Input FeatureBuilder::ReadInput(const DevObject *object)
+    {
+        Input input;
+        if (!object)
+            return input;
+
+        auto object_ptr = const_cast<DevObject *>(object);
+        std::string_view type = object->TypeName.GetValue();
+        if (type == "Box")
+        {
+            input.kind = Kind::Box;
+            input.position = object_ptr->GetPropertyVector("Position")->GetValue();
+            input.length = object_ptr->GetPropertyFloatValue("Length");
+            input.width = object_ptr->GetPropertyFloatValue("Width");
+            input.height = object_ptr->GetPropertyFloatValue("Height");
+        }
+        else if (type == "CurvesLoft")
+        {
+            input.kind = Kind::CurvesLoft;
+            input.edge1 = GetShapeProperty(object, "TopeShape1");
+            input.edge2 = GetShapeProperty(object, "TopeShape2");
+        }
+        return input;
+    }
+
+    AMCAX::TopoShape FeatureBuilder::Build(const Input &input)
+    {
+        if (input.kind == Kind::None)
+            return AMCAX::TopoShape();
+
+        auto &cache = FeatureCache::GetInstance();
+        if (cache.IsEnabled())
+        {
+            if (auto cached = cache.Find(input))
+                return *cached;
+        }
+
+        auto shape = BuildUncached(input);
+        if (cache.IsEnabled() && !shape.IsNull())
+            cache.Insert(input, shape);
+        return shape;
+    }
+
+    AMCAX::TopoShape FeatureBuilder::BuildUncached(const Input &input)
+    {
+        switch (input.kind)
+        {
+        case Kind::Box:
+            return BuildBox(input.position, input.length, input.width, input.height);
+        case Kind::CurvesLoft:
+            if (input.edge1.IsNull() || input.edge2.IsNull() ||
+                input.edge1.Type() != AMCAX::ShapeType::Edge || input.edge2.Type() != AMCAX::ShapeType::Edge)
+                return AMCAX::TopoShape();
+            return BuildCurvesLoft(static_cast<const AMCAX::TopoEdge &>(input.edge1), static_cast<const AMCAX::TopoEdge &>(input.edge2));
+        default:
+            return AMCAX::TopoShape();
+        }
+    }
+
+    AMCAX::TopoShape FeatureBuilder::BuildBox(const base::Vector3d &position, double length, double width, double height)
+    {
+        try
+        {
+            AMCAX::Point3 origin(position.x, position.y, position.z);
+            return AMCAX::MakeBox(origin, length, width, height).Shape();
+        }
+        catch (...)
+        {
+            return AMCAX::TopoShape();
+        }
+    }
+
+    AMCAX::TopoFace FeatureBuilder::BuildCurvesLoft(const AMCAX::TopoEdge &edge1, const AMCAX::TopoEdge &edge2)
+    {
+        std::vector<AMCAX::NURBSCurveSection> sections;
+        for (auto const &edge : {edge1, edge2})
+        {
+            auto geo3Curve = AMCAX::NURBSAPIGetGeometry::GetCurve(edge);
+            if (edge.Orientation() == AMCAX::OrientationType::Reversed)
+            { //注意几何Curve的方向和拓扑Edge的方向是无关联的，需要根据拓扑的方向来调整几何的方向
+                geo3Curve->Reverse();
+            }
+            sections.push_back(AMCAX::NURBSCurveSection(geo3Curve));
+        }
+
+        try
+        {
+            auto loft = AMCAX::NURBSAPILoft::MakeLoft(sections);
+            AMCAX::MakeFace surface(loft, 1e-6);
+            return surface.Face();
+        }
+        catch (...)
+        {
+            return AMCAX::TopoFace();
+        }
+    }
+
+} // namespace Dev
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <Base/Vector3D.h>
+#include <topology/TopoEdge.hpp>
+#include <topology/TopoShape.hpp>
+
+namespace Dev {
+
+class DevObject;
+
+/**
+ * @brief Dev特征的输入快照与形状生成
+ *
+ * ReadInput在GUI线程读取特征属性，得到的输入与文档对象无关；
+ * Build只依赖输入，可以在任意线程中执行。对话框预览与重新计算共用这里的生成逻辑。
+ */
+class FeatureBuilder
+{
+  public:
+    enum class Kind
+    {
+        None,
+        Box,
+        CurvesLoft
+    };
+
+    struct Input
+    {
+        Kind kind = Kind::None;
+        // Box
+        base::Vector3d position;
+        double length = 0.0;
+        double width = 0.0;
+        double height = 0.0;
+        // CurvesLoft，方向已包含在边的Orientation中
+        AMCAX::TopoShape edge1;
+        AMCAX::TopoShape edge2;
+    };
+
+    // 按TypeName读取特征的输入，不支持的特征返回Kind::None
+    static Input ReadInput(const DevObject* object);
+    // 生成失败时返回空形状；相同输入的结果由FeatureCache缓存
+    static AMCAX::TopoShape Build(const Input& input);
+    static AMCAX::TopoShape BuildUncached(const Input& input);
+
+    static AMCAX::TopoShape BuildBox(const base::Vector3d& position, double length, double width, double height);
+    // 由两条边放样生成曲面，放样失败时返回空面
+    static AMCAX::TopoFace BuildCurvesLoft(const AMCAX::TopoEdge& edge1, const AMCAX::TopoEdge& edge2);
+};
+
+}  // namespace Dev
@@ -0,0 +1,208 @@
+#include "FeatureCache.h"
+#include <App/Application.h>
+#include <Base/Parameter.h>
+#include <functional>
+#include <geometry/Geom3BSplineCurve.hpp>
+#include <geometry/Geom3BSplineSurface.hpp>
+#include <topology/TopoEdge.hpp>
+#include <topology/TopoExplorer.hpp>
+#include <topology/TopoFace.hpp>
+#include <topology/TopoTool.hpp>
+
+namespace Dev
+{
+    namespace
+    {
+        constexpr std::size_t kDefaultCacheSizeMB = 256;
+
+        // 拓扑对象本身的大致开销
+        constexpr std::size_t kVertexBytes = 128;
+        constexpr std::size_t kEdgeBytes = 512;
+        constexpr std::size_t kFaceBytes = 1024;
+
+        void HashCombine(std::size_t &seed, std::size_t value)
+        {
+            seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+        }
+
+        void HashShape(std::size_t &seed, const AMCAX::TopoShape &shape)
+        {
+            if (shape.IsNull())
+            {
+                HashCombine(seed, 0);
+                return;
+            }
+            // std::hash<TopoShape>不区分方向，反向后的边需要单独区分
+            HashCombine(seed, std::hash<AMCAX::TopoShape>{}(shape));
+            HashCombine(seed, static_cast<std::size_t>(shape.Orientation()));
+        }
+
+        bool IsSameShape(const AMCAX::TopoShape &a, const AMCAX::TopoShape &b)
+        {
+            if (a.IsNull() || b.IsNull())
+                return a.IsNull() && b.IsNull();
+            return a.IsEqual(b);
+        }
+    } // namespace
+
+    FeatureCache &FeatureCache::GetInstance()
+    {
+        static FeatureCache instance;
+        return instance;
+    }
+
+    FeatureCache::FeatureCache()
+        : m_capacity(kDefaultCacheSizeMB * 1024 * 1024), m_enabled(true)
+    {
+        auto grp = app::GetApplication().GetUserParameter().GetGroup("BaseApp/Preferences/Mod/Dev/Recompute");
+        if (grp)
+        {
+            m_enabled = grp->GetBool("FeatureCache", true);
+            m_capacity = static_cast<std::size_t>(grp->GetInt("FeatureCacheSize", static_cast<int>(kDefaultCacheSizeMB))) * 1024 * 1024;
+        }
+    }
+
+    std::optional<AMCAX::TopoShape> FeatureCache::Find(const FeatureBuilder::Input &input)
+    {
+        auto hash = ComputeHash(input);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = Lookup(hash, input);
+        if (it == m_entries.end())
+            return std::nullopt;
+        m_entries.splice(m_entries.begin(), m_entries, it);
+        return it->shape;
+    }
+
+    void FeatureCache::Insert(const FeatureBuilder::Input &input, const AMCAX::TopoShape &shape)
+    {
+        auto hash = ComputeHash(input);
+        auto bytes = EstimateSize(shape);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (bytes > m_capacity)
+            return;
+
+        if (auto it = Lookup(hash, input); it != m_entries.end())
+        {
+            m_bytes -= it->bytes;
+            it->shape = shape;
+            it->bytes = bytes;
+            m_bytes += bytes;
+            m_entries.splice(m_entries.begin(), m_entries, it);
+        }
+        else
+        {
+            m_entries.push_front(Entry{hash, input, shape, bytes});
+            m_index.emplace(hash, m_entries.begin());
+            m_bytes += bytes;
+        }
+        Evict();
+    }
+
+    void FeatureCache::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.clear();
+        m_index.clear();
+        m_bytes = 0;
+    }
+
+    std::size_t FeatureCache::EstimateSize(const AMCAX::TopoShape &shape)
+    {
+        if (shape.IsNull())
+            return 0;
+
+        std::size_t bytes = 0;
+        for (AMCAX::TopoExplorer exp(shape, AMCAX::ShapeType::Vertex); exp.More(); exp.Next())
+            bytes += kVertexBytes;
+        for (AMCAX::TopoExplorer exp(shape, AMCAX::ShapeType::Edge); exp.More(); exp.Next())
+        {
+            bytes += kEdgeBytes;
+            double first, last;
+            auto curve = AMCAX::TopoTool::Curve(static_cast<const AMCAX::TopoEdge &>(exp.Current()), first, last);
+            if (auto bspline = std::dynamic_pointer_cast<AMCAX::Geom3BSplineCurve>(curve))
+                bytes += bspline->NPoles() * (sizeof(AMCAX::Point3) + sizeof(double)) + bspline->NKnots() * 2 * sizeof(double);
+        }
+        for (AMCAX::TopoExplorer exp(shape, AMCAX::ShapeType::Face); exp.More(); exp.Next())
+        {
+            bytes += kFaceBytes;
+            auto surface = AMCAX::TopoTool::Surface(static_cast<const AMCAX::TopoFace &>(exp.Current()));
+            if (auto bspline = std::dynamic_pointer_cast<AMCAX::Geom3BSplineSurface>(surface))
+            {
+                bytes += static_cast<std::size_t>(bspline->NUPoles()) * bspline->NVPoles() * (sizeof(AMCAX::Point3) + sizeof(double));
+                bytes += (bspline->NUKnots() + bspline->NVKnots()) * 2 * sizeof(double);
+            }
+        }
+        return bytes;
+    }
+
+    std::size_t FeatureCache::ComputeHash(const FeatureBuilder::Input &input)
+    {
+        std::size_t seed = static_cast<std::size_t>(input.kind);
+        switch (input.kind)
+        {
+        case FeatureBuilder::Kind::Box:
+            HashCombine(seed, std::hash<double>{}(input.position.x));
+            HashCombine(seed, std::hash<double>{}(input.position.y));
+            HashCombine(seed, std::hash<double>{}(input.position.z));
+            HashCombine(seed, std::hash<double>{}(input.length));
+            HashCombine(seed, std::hash<double>{}(input.width));
+            HashCombine(seed, std::hash<double>{}(input.height));
+            break;
+        case FeatureBuilder::Kind::CurvesLoft:
+            HashShape(seed, input.edge1);
+            HashShape(seed, input.edge2);
+            break;
+        default:
+            break;
+        }
+        return seed;
+    }
+
+    bool FeatureCache::IsSameInput(const FeatureBuilder::Input &a, const FeatureBuilder::Input &b)
+    {
+        if (a.kind != b.kind)
+            return false;
+        switch (a.kind)
+        {
+        case FeatureBuilder::Kind::Box:
+            return a.position.x == b.position.x && a.position.y == b.position.y && a.position.z == b.position.z &&
+                   a.length == b.length && a.width == b.width && a.height == b.height;
+        case FeatureBuilder::Kind::CurvesLoft:
+            return IsSameShape(a.edge1, b.edge1) && IsSameShape(a.edge2, b.edge2);
+        default:
+            return true;
+        }
+    }
+
+    FeatureCache::EntryList::iterator FeatureCache::Lookup(std::size_t hash, const FeatureBuilder::Input &input)
+    {
+        auto [begin, end] = m_index.equal_range(hash);
+        for (auto it = begin; it != end; ++it)
+        {
+            if (IsSameInput(it->second->input, input))
+                return it->second;
+        }
+        return m_entries.end();
+    }
+
+    void FeatureCache::Evict()
+    {
+        while (m_bytes > m_capacity && !m_entries.empty())
+        {
+            auto last = std::prev(m_entries.end());
+            auto [begin, end] = m_index.equal_range(last->hash);
+            for (auto it = begin; it != end; ++it)
+            {
+                if (it->second == last)
+                {
+                    m_index.erase(it);
+                    break;
+                }
+            }
+            m_bytes -= last->bytes;
+            m_entries.erase(last);
+        }
+    }
+
+} // namespace Dev
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <Base/Object/FeatureBuilder.h>
+
+namespace Dev {
+
+/**
+ * @brief 特征生成结果的内存缓存
+ *
+ * 以FeatureBuilder::Input为键：尺寸按数值精确比较，边按TShape、位置与方向比较（IsEqual）。
+ * 撤销、重做或在对话框中回到之前的参数时，属性中的边仍共享原来的TShape，可直接命中。
+ * 按估算的内存占用淘汰最久未使用的结果，可在多个线程中同时使用。
+ */
+class FeatureCache
+{
+  public:
+    static FeatureCache& GetInstance();
+
+    // 用户参数 BaseApp/Preferences/Mod/Dev/Recompute 下的 FeatureCache、FeatureCacheSize（MB），创建时读取一次
+    bool IsEnabled() const { return m_enabled; }
+
+    std::optional<AMCAX::TopoShape> Find(const FeatureBuilder::Input& input);
+    void Insert(const FeatureBuilder::Input& input, const AMCAX::TopoShape& shape);
+    void Clear();
+
+    // 形状的内存占用估算，B样条按控制点与节点计算，其余拓扑按固定开销计算
+    static std::size_t EstimateSize(const AMCAX::TopoShape& shape);
+
+  private:
+    FeatureCache();
+
+    struct Entry
+    {
+        std::size_t hash;
+        FeatureBuilder::Input input;
+        AMCAX::TopoShape shape;
+        std::size_t bytes;
+    };
+    using EntryList = std::list<Entry>;
+
+    static std::size_t ComputeHash(const FeatureBuilder::Input& input);
+    static bool IsSameInput(const FeatureBuilder::Input& a, const FeatureBuilder::Input& b);
+    EntryList::iterator Lookup(std::size_t hash, const FeatureBuilder::Input& input);
+    void Evict();
+
+  private:
+    std::mutex m_mutex;
+    // 表头为最近使用
+    EntryList m_entries;
+    std::unordered_multimap<std::size_t, EntryList::iterator> m_index;
+    std::size_t m_bytes = 0;
+    std::size_t m_capacity;
+    bool m_enabled;
+};
+
+}  // namespace Dev
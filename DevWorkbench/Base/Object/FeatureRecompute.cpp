@@ -0,0 +1,175 @@
+#include "FeatureRecompute.h"
+#include "DevObject.h"
+#include "FeatureBuilder.h"
+#include "FeatureCache.h"
+#include <App/Application.h>
+#include <Base/DevSetup.h>
+#include <Base/Parameter.h>
+#include <Base/PartCollection.h>
+#include <Base/ShapeTransaction.h>
+#include <chrono>
+#include <tbb/parallel_for.h>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Dev
+{
+    namespace
+    {
+        // 按依赖分层，每层只依赖之前的层；存在环时剩余对象放在最后一层
+        std::vector<std::vector<DevObject *>> BuildLevels(const std::vector<DevObject *> &objects)
+        {
+            std::unordered_map<const app::DocumentObject *, DevObject *> members;
+            members.reserve(objects.size());
+            for (auto object : objects)
+            {
+                if (object)
+                    members.emplace(object, object);
+            }
+
+            std::unordered_map<DevObject *, int> pending;
+            std::unordered_map<DevObject *, std::vector<DevObject *>> dependents;
+            pending.reserve(members.size());
+            for (auto const &[key, object] : members)
+            {
+                int count = 0;
+                for (auto dep : object->GetOutList())
+                {
+                    auto it = members.find(dep);
+                    if (it == members.end() || it->second == object)
+                        continue;
+                    dependents[it->second].push_back(object);
+                    ++count;
+                }
+                pending[object] = count;
+            }
+
+            std::vector<std::vector<DevObject *>> levels;
+            std::vector<DevObject *> current;
+            // 保持调用者给出的顺序，写入顺序因此是确定的
+            for (auto object : objects)
+            {
+                if (object && pending[object] == 0)
+                    current.push_back(object);
+            }
+
+            std::size_t placed = 0;
+            while (!current.empty())
+            {
+                placed += current.size();
+                std::vector<DevObject *> next;
+                for (auto object : current)
+                {
+                    for (auto dependent : dependents[object])
+                    {
+                        if (--pending[dependent] == 0)
+                            next.push_back(dependent);
+                    }
+                }
+                levels.push_back(std::move(current));
+                current = std::move(next);
+            }
+
+            if (placed < members.size())
+            {
+                std::vector<DevObject *> rest;
+                for (auto object : objects)
+                {
+                    if (object && pending[object] > 0)
+                        rest.push_back(object);
+                }
+                levels.push_back(std::move(rest));
+            }
+            return levels;
+        }
+
+        // 自身被修改（IsTouched、MustExecute）或依赖的特征需要重新计算时才计算
+        bool NeedsRecompute(const DevObject *object, const std::unordered_set<const app::DocumentObject *> &dirty)
+        {
+            if (object->IsTouched() || object->MustExecute() > 0)
+                return true;
+            for (auto dep : object->GetOutList())
+            {
+                if (dep != object && dirty.count(dep))
+                    return true;
+            }
+            return false;
+        }
+    } // namespace
+
+    bool FeatureRecompute::IsParallelEnabled()
+    {
+        auto grp = app::GetApplication().GetUserParameter().GetGroup("BaseApp/Preferences/Mod/Dev/Recompute");
+        if (!grp)
+            return true;
+        return grp->GetBool("Parallel", true);
+    }
+
+    std::vector<FeatureRecompute::Timing> FeatureRecompute::Recompute(const std::vector<DevObject *> &objects, bool parallel)
+    {
+        std::vector<Timing> timings;
+        timings.reserve(objects.size());
+
+        // 缓存在创建时读取用户参数，先在GUI线程中创建
+        FeatureCache::GetInstance();
+
+        auto setup = DevSetup::GetCurDevSetup();
+        PartCollection::ScopedBatch batch(setup ? setup->DevPartCollection() : nullptr);
+
+        // 层按依赖顺序排列，依赖的特征总在之前的层中判断过
+        std::unordered_set<const app::DocumentObject *> dirty;
+        for (auto const &all : BuildLevels(objects))
+        {
+            std::vector<DevObject *> level;
+            level.reserve(all.size());
+            for (auto object : all)
+            {
+                if (NeedsRecompute(object, dirty))
+                {
+                    dirty.insert(object);
+                    level.push_back(object);
+                }
+            }
+            if (level.empty())
+                continue;
+
+            // 输入在GUI线程读取，工作线程不访问文档对象
+            std::vector<FeatureBuilder::Input> inputs;
+            inputs.reserve(level.size());
+            for (auto object : level)
+                inputs.push_back(FeatureBuilder::ReadInput(object));
+
+            std::vector<AMCAX::TopoShape> shapes(level.size());
+            std::vector<double> durations(level.size(), 0.0);
+            auto build = [&](std::size_t i)
+            {
+                auto start = std::chrono::steady_clock::now();
+                shapes[i] = FeatureBuilder::Build(inputs[i]);
+                durations[i] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            };
+
+            if (parallel && level.size() > 1)
+                tbb::parallel_for(std::size_t(0), level.size(), build);
+            else
+                for (std::size_t i = 0; i < level.size(); ++i)
+                    build(i);
+
+            for (std::size_t i = 0; i < level.size(); ++i)
+            {
+                // 不是由FeatureBuilder生成形状的特征保持原样
+                if (inputs[i].kind == FeatureBuilder::Kind::None)
+                    continue;
+                bool succeeded = !shapes[i].IsNull();
+                if (succeeded)
+                {
+                    ShapeTransaction::SetShape(level[i]->Shape, shapes[i]);
+                    // 写入Shape会再次标记修改，写入后清除；失败的特征保留标记，下次重新计算
+                    level[i]->PurgeTouched();
+                }
+                timings.push_back({level[i], durations[i], succeeded});
+            }
+        }
+        return timings;
+    }
+
+} // namespace Dev
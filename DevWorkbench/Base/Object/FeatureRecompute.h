@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+
+namespace Dev {
+
+class DevObject;
+
+/**
+ * @brief Dev特征的分层并行重新计算
+ *
+ * 按GetOutList把特征分层，同一层内的特征互不依赖。只计算被修改（IsTouched、MustExecute）
+ * 或依赖了需要重新计算的特征，写入成功后清除修改标记。
+ * 每层先在GUI线程读取输入，再在TBB线程池中并行调用FeatureBuilder::Build，
+ * 最后回到GUI线程按顺序写入Shape属性，属性信号只在GUI线程中发出。
+ */
+class FeatureRecompute
+{
+  public:
+    struct Timing
+    {
+        const DevObject* object = nullptr;
+        double milliseconds = 0.0;
+        bool succeeded = false;
+    };
+
+    // 用户参数 BaseApp/Preferences/Mod/Dev/Recompute/Parallel
+    static bool IsParallelEnabled();
+
+    // 返回实际计算的特征的耗时，顺序与写入顺序一致；没有需要计算的特征时为空
+    static std::vector<Timing> Recompute(const std::vector<DevObject*>& objects, bool parallel = IsParallelEnabled());
+};
+
+}  // namespace Dev
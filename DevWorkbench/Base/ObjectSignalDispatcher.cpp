@@ -0,0 +1,140 @@
+#include "ObjectSignalDispatcher.h"
+#include <App/Document.h>
+#include <App/DocumentObject.h>
+#include <App/Property.h>
+#include <algorithm>
+
+namespace Dev
+{
+    template <typename Signature>
+    ObjectSignalDispatcher::Connection ObjectSignalDispatcher::Table<Signature>::Add(base::Type type,
+                                                                                     std::function<Signature> slot,
+                                                                                     std::vector<std::string> properties)
+    {
+        auto entry = std::make_unique<Entry<Signature>>();
+        entry->type = type;
+        entry->properties.insert(properties.begin(), properties.end());
+        auto connection = entry->signal.connect(std::move(slot));
+        pending.push_back(std::move(entry));
+        if (depth == 0)
+            Compact();
+        return connection;
+    }
+
+    template <typename Signature>
+    void ObjectSignalDispatcher::Table<Signature>::Compact()
+    {
+        auto removed = std::remove_if(entries.begin(), entries.end(), [](const std::unique_ptr<Entry<Signature>> &entry)
+                                      { return entry->signal.empty(); });
+        if (removed == entries.end() && pending.empty())
+            return;
+        entries.erase(removed, entries.end());
+        for (auto &entry : pending)
+            entries.push_back(std::move(entry));
+        pending.clear();
+        // 新订阅可能匹配已缓存的类型
+        matches.clear();
+    }
+
+    template <typename Signature>
+    const std::vector<ObjectSignalDispatcher::Entry<Signature> *> &ObjectSignalDispatcher::Table<Signature>::Match(const app::DocumentObject &obj)
+    {
+        auto type = obj.GetClassTypePolymorphic();
+        auto it = matches.find(type.GetIndex());
+        if (it != matches.end())
+            return it->second;
+
+        std::vector<Entry<Signature> *> matched;
+        for (auto const &entry : entries)
+        {
+            if (type.IsSubTypeOf(entry->type))
+                matched.push_back(entry.get());
+        }
+        return matches.emplace(type.GetIndex(), std::move(matched)).first->second;
+    }
+
+    ObjectSignalDispatcher::ObjectSignalDispatcher(app::Document *doc)
+        : m_document(doc)
+    {
+    }
+
+    ObjectSignalDispatcher::~ObjectSignalDispatcher()
+    {
+        m_new_object.source.disconnect();
+        m_deleted_object.source.disconnect();
+        m_before_property_changed.source.disconnect();
+        m_property_changed.source.disconnect();
+    }
+
+    app::Document *ObjectSignalDispatcher::GetDocument() const
+    {
+        return m_document;
+    }
+
+    // 首次订阅某种信号时才连接文档，未订阅的信号没有任何开销
+    ObjectSignalDispatcher::Connection ObjectSignalDispatcher::ConnectNewObject(base::Type type, ObjectSlot slot)
+    {
+        if (!m_new_object.source.connected())
+        {
+            m_new_object.source = m_document->SignalNewObject.connect([this](const app::DocumentObject &obj)
+                                                                      { Dispatch(m_new_object, obj); });
+        }
+        return m_new_object.Add(type, std::move(slot), {});
+    }
+
+    ObjectSignalDispatcher::Connection ObjectSignalDispatcher::ConnectDeletedObject(base::Type type, ObjectSlot slot)
+    {
+        if (!m_deleted_object.source.connected())
+        {
+            m_deleted_object.source = m_document->SignalDeletingObject.connect([this](const app::DocumentObject &obj)
+                                                                               { Dispatch(m_deleted_object, obj); });
+        }
+        return m_deleted_object.Add(type, std::move(slot), {});
+    }
+
+    ObjectSignalDispatcher::Connection ObjectSignalDispatcher::ConnectBeforePropertyChanged(base::Type type, PropertySlot slot, std::vector<std::string> properties)
+    {
+        if (!m_before_property_changed.source.connected())
+        {
+            m_before_property_changed.source = m_document->SignalBeforeObjectPropertyChanging.connect([this](const app::DocumentObject &obj, const app::Property &prop)
+                                                                                                      { Dispatch(m_before_property_changed, obj, prop); });
+        }
+        return m_before_property_changed.Add(type, std::move(slot), std::move(properties));
+    }
+
+    ObjectSignalDispatcher::Connection ObjectSignalDispatcher::ConnectPropertyChanged(base::Type type, PropertySlot slot, std::vector<std::string> properties)
+    {
+        if (!m_property_changed.source.connected())
+        {
+            m_property_changed.source = m_document->SignalObjectPropertyChanged.connect([this](const app::DocumentObject &obj, const app::Property &prop)
+                                                                                        { Dispatch(m_property_changed, obj, prop); });
+        }
+        return m_property_changed.Add(type, std::move(slot), std::move(properties));
+    }
+
+    void ObjectSignalDispatcher::Dispatch(Table<ObjectSignature> &table, const app::DocumentObject &obj)
+    {
+        auto const &matched = table.Match(obj);
+        if (matched.empty())
+            return;
+        // 回调中新增或断开的订阅在派发结束后处理，matched在此期间保持有效
+        DispatchScope<ObjectSignature> scope(table);
+        for (auto entry : matched)
+            entry->signal(obj);
+    }
+
+    void ObjectSignalDispatcher::Dispatch(Table<PropertySignature> &table, const app::DocumentObject &obj, const app::Property &prop)
+    {
+        auto const &matched = table.Match(obj);
+        if (matched.empty())
+            return;
+        DispatchScope<PropertySignature> scope(table);
+        for (auto entry : matched)
+        {
+            if (!entry->properties.empty() && !entry->properties.contains(prop.GetName()))
+                continue;
+            entry->signal(obj, prop);
+        }
+    }
+
+} // namespace Dev
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <boost/signals2.hpp>
+#include <Base/Type.h>
+
+namespace app {
+class Document;
+class DocumentObject;
+class Property;
+}
+
+namespace Dev {
+
+/**
+ * @brief 按对象类型、属性名过滤的文档信号
+ *
+ * 对每种文档信号只向app::Document连接一次，订阅时给出对象类型（含子类型）与可选的属性名。
+ * 每个具体类型匹配到的订阅在第一次收到该类型对象的信号时确定并缓存，
+ * 之后派发只需一次查表，不匹配的对象与属性不会调用任何订阅者。
+ * 派发期间（包括回调中再次触发的派发）新增的订阅延后到最外层派发结束时才并入，
+ * 已断开的订阅在不处于派发中时移除，派发过程中匹配表保持不变，无需复制。
+ */
+class ObjectSignalDispatcher
+{
+  public:
+    using Connection = boost::signals2::connection;
+    using ObjectSlot = std::function<void(const app::DocumentObject&)>;
+    using PropertySlot = std::function<void(const app::DocumentObject&, const app::Property&)>;
+
+    explicit ObjectSignalDispatcher(app::Document* doc);
+    ~ObjectSignalDispatcher();
+
+    app::Document* GetDocument() const;
+
+    Connection ConnectNewObject(base::Type type, ObjectSlot slot);
+    Connection ConnectDeletedObject(base::Type type, ObjectSlot slot);
+    // properties为空时接收该类型对象的所有属性变化
+    Connection ConnectBeforePropertyChanged(base::Type type, PropertySlot slot, std::vector<std::string> properties = {});
+    Connection ConnectPropertyChanged(base::Type type, PropertySlot slot, std::vector<std::string> properties = {});
+
+  private:
+    struct StringHash
+    {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view str) const { return std::hash<std::string_view>{}(str); }
+    };
+
+    template <typename Signature>
+    struct Entry
+    {
+        base::Type type;
+        std::unordered_set<std::string, StringHash, std::equal_to<>> properties;
+        boost::signals2::signal<Signature> signal;
+    };
+
+    template <typename Signature>
+    struct Table
+    {
+        std::vector<std::unique_ptr<Entry<Signature>>> entries;
+        // 具体类型的序号到匹配的订阅
+        std::unordered_map<unsigned int, std::vector<Entry<Signature>*>> matches;
+        Connection source;
+        // 正在进行的派发层数
+        int depth = 0;
+        // 派发期间新增的订阅
+        std::vector<std::unique_ptr<Entry<Signature>>> pending;
+
+        Connection Add(base::Type type, std::function<Signature> slot, std::vector<std::string> properties);
+        const std::vector<Entry<Signature>*>& Match(const app::DocumentObject& obj);
+        // 并入延后的订阅并移除已断开的订阅，只在不处于派发中时调用
+        void Compact();
+    };
+
+    // 派发期间保持depth，退出时处理延后的增删
+    template <typename Signature>
+    class DispatchScope
+    {
+      public:
+        explicit DispatchScope(Table<Signature>& table)
+            : m_table(table)
+        {
+            ++m_table.depth;
+        }
+        ~DispatchScope()
+        {
+            if (--m_table.depth == 0)
+                m_table.Compact();
+        }
+
+      private:
+        Table<Signature>& m_table;
+    };
+
+    using ObjectSignature = void(const app::DocumentObject&);
+    using PropertySignature = void(const app::DocumentObject&, const app::Property&);
+
+    static void Dispatch(Table<ObjectSignature>& table, const app::DocumentObject& obj);
+    static void Dispatch(Table<PropertySignature>& table, const app::DocumentObject& obj, const app::Property& prop);
+
+  private:
+    app::Document* m_document;
+    Table<ObjectSignature> m_new_object;
+    Table<ObjectSignature> m_deleted_object;
+    Table<PropertySignature> m_before_property_changed;
+    Table<PropertySignature> m_property_changed;
+};
+
+}  // namespace Dev
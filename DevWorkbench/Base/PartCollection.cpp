@@ -1,5 +1,7 @@
 #include "PartCollection.h"
 #include "DevSetup.h"
+#include "FaceAttributeIndex.h"
+#include "SubShapeIndex.h"
 #include <App/Application.h>
 #include <App/Document.h>
 #include <App/DocumentObject.h>
@@ -9,6 +11,7 @@ namespace Dev {
 
 PartCollection::PartCollection(DevSetup* owner)
   : m_owner(owner)
+  , m_batch_depth(0)
 {
 }
 
@@ -20,6 +23,12 @@ PartCollection::~PartCollection()
 void PartCollection::Clear()
 {
     m_parts.clear();
+    m_name_index.clear();
+    m_label_count.clear();
+    m_part_labels.clear();
+    m_suffix_counters.clear();
+    SubShapeIndex::GetInstance().Clear();
+    FaceAttributeIndex::GetInstance().Clear();
     if (connectNewObject.connected())
         connectNewObject.disconnect();
     if (connectDeletedObject.connected())
@@ -28,6 +37,7 @@ void PartCollection::Clear()
         connectBeforeObjectPropertyChanged.disconnect();
     if (connectObjectPropertyChanged.connected())
         connectObjectPropertyChanged.disconnect();
+    m_dispatcher.reset();
 }
 
 DevSetup* PartCollection::GetSetup()
@@ -42,10 +52,7 @@ std::vector<app::DocumentObjectTopoShape*> PartCollection::PartList()
 
 bool PartCollection::IsLabelUnique(std::string_view label)
 {
-    for (auto part : m_parts)
-        if (part->Label.GetValue() == label)
-            return false;
-    return true;
+    return m_label_count.find(label) == m_label_count.end();
 }
 
 std::string PartCollection::GetUniqueName(std::string_view name)
@@ -59,14 +66,13 @@ std::string PartCollection::GetUniqueName(std::string_view name)
     }
     else
     {
-        std::string cleanName = base::Tools::GetIdentifierWithChinese(name);
-        std::vector<std::string_view> names;
-        names.reserve(m_parts.size());
-        for (auto group : m_parts)
-        {
-            names.push_back(group->Label.GetValue());
-        }
-        return base::Tools::GetUniqueName(cleanName + "_", names, 1);
+        // 从该前缀上次返回的序号开始尝试，连续添加同名部件时每次只需检查一两个候选
+        std::string prefix = base::Tools::GetIdentifierWithChinese(name) + "_";
+        auto& counter = m_suffix_counters.try_emplace(prefix, 1).first->second;
+        std::string candidate = prefix + std::to_string(counter);
+        while (!IsLabelUnique(candidate))
+            candidate = prefix + std::to_string(++counter);
+        return candidate;
     }
 }
 
@@ -74,23 +80,57 @@ void PartCollection::Setup(app::Document* doc, std::vector<app::DocumentObjectTo
 {
     Clear();
     m_parts = parts;
+    for (auto part : m_parts)
+        AddToIndex(part);
 
-    connectNewObject = doc->SignalNewObject.connect(std::bind(&Dev::PartCollection::SlotNewObject, this, std::placeholders::_1));
-    connectDeletedObject = doc->SignalDeletingObject.connect(std::bind(&Dev::PartCollection::SlotObjectDeleted, this, std::placeholders::_1));
-    connectBeforeObjectPropertyChanged = doc->SignalBeforeObjectPropertyChanging.connect(std::bind(&Dev::PartCollection::SlotObjectBeforePropertyChanged, this, std::placeholders::_1, std::placeholders::_2));
-    connectObjectPropertyChanged = doc->SignalObjectPropertyChanged.connect(std::bind(&Dev::PartCollection::SlotObjectPropertyChanged, this, std::placeholders::_1, std::placeholders::_2));
+    auto part_type = app::DocumentObjectTopoShape::GetClassType();
+    m_dispatcher = std::make_unique<ObjectSignalDispatcher>(doc);
+    connectNewObject = m_dispatcher->ConnectNewObject(part_type, std::bind(&Dev::PartCollection::SlotNewObject, this, std::placeholders::_1));
+    connectDeletedObject = m_dispatcher->ConnectDeletedObject(part_type, std::bind(&Dev::PartCollection::SlotObjectDeleted, this, std::placeholders::_1));
+    connectBeforeObjectPropertyChanged = m_dispatcher->ConnectBeforePropertyChanged(part_type, std::bind(&Dev::PartCollection::SlotObjectBeforePropertyChanged, this, std::placeholders::_1, std::placeholders::_2));
+    connectObjectPropertyChanged = m_dispatcher->ConnectPropertyChanged(part_type, std::bind(&Dev::PartCollection::SlotObjectPropertyChanged, this, std::placeholders::_1, std::placeholders::_2));
 }
 
 app::DocumentObjectTopoShape* PartCollection::FindObject(std::string_view name)
 {
-    for (auto part : m_parts)
-    {
-        if (part->GetNameInDocument() == name)
-        {
-            return part;
-        }
-    }
-    return nullptr;
+    auto it = m_name_index.find(name);
+    return it == m_name_index.end() ? nullptr : it->second;
+}
+
+void PartCollection::AddToIndex(app::DocumentObjectTopoShape* part)
+{
+    m_name_index[std::string(part->GetNameInDocument())] = part;
+    std::string label(part->Label.GetValue());
+    ++m_label_count[label];
+    m_part_labels[part] = std::move(label);
+}
+
+void PartCollection::RemoveFromIndex(app::DocumentObjectTopoShape* part)
+{
+    auto name = m_name_index.find(part->GetNameInDocument());
+    if (name != m_name_index.end() && name->second == part)
+        m_name_index.erase(name);
+
+    auto label = m_part_labels.find(part);
+    if (label == m_part_labels.end())
+        return;
+    auto count = m_label_count.find(label->second);
+    if (count != m_label_count.end() && --count->second <= 0)
+        m_label_count.erase(count);
+    m_part_labels.erase(label);
+}
+
+void PartCollection::UpdateLabelIndex(const app::DocumentObjectTopoShape* part)
+{
+    auto label = m_part_labels.find(part);
+    if (label == m_part_labels.end() || label->second == part->Label.GetValue())
+        return;
+
+    auto count = m_label_count.find(label->second);
+    if (count != m_label_count.end() && --count->second <= 0)
+        m_label_count.erase(count);
+    label->second = part->Label.GetValue();
+    ++m_label_count[label->second];
 }
 
 void PartCollection::SetSortList(const std::map<std::string, std::vector<std::string>>& map)
@@ -119,49 +159,115 @@ void PartCollection::RemovePart(app::DocumentObjectTopoShape* part)
     RemovePart(part->GetNameInDocument());
 }
 
-void PartCollection::SlotNewObject(const app::DocumentObject& obj)
+void PartCollection::BeginBatch()
+{
+    ++m_batch_depth;
+}
+
+void PartCollection::EndBatch()
 {
-    auto type = obj.GetClassTypePolymorphic();
-    if (!type.IsSubTypeOf(app::DocumentObjectTopoShape::GetClassType()))
+    if (m_batch_depth == 0 || --m_batch_depth > 0)
         return;
 
+    std::vector<const app::DocumentObject*> objects;
+    objects.swap(m_batch_objects);
+    m_batch_object_set.clear();
+    std::vector<const app::DocumentObject*> changed;
+    changed.swap(m_changed_objects);
+    m_changed_object_set.clear();
+
+    if (!objects.empty())
+        SignalNewObjects(objects);
+    if (!changed.empty())
+        SignalObjectsChanged(changed);
+}
+
+bool PartCollection::IsInBatch() const
+{
+    return m_batch_depth > 0;
+}
+
+PartCollection::ScopedBatch::ScopedBatch(PartCollection* collection)
+  : m_collection(collection)
+{
+    if (m_collection)
+        m_collection->BeginBatch();
+}
+
+PartCollection::ScopedBatch::~ScopedBatch()
+{
+    if (m_collection)
+        m_collection->EndBatch();
+}
+
+// 以下槽函数由m_dispatcher按部件类型过滤后调用
+void PartCollection::SlotNewObject(const app::DocumentObject& obj)
+{
     app::DocumentObject* part_obj = const_cast<app::DocumentObject*>(&obj);
     auto part = dynamic_cast<app::DocumentObjectTopoShape*>(part_obj);
     m_parts.emplace_back(part);
+    AddToIndex(part);
+
+    if (IsInBatch())
+    {
+        m_batch_objects.push_back(&obj);
+        m_batch_object_set.insert(&obj);
+        return;
+    }
 
     SignalNewObject(obj);
 }
 
 void PartCollection::SlotObjectDeleted(const app::DocumentObject& obj)
 {
-    auto type = obj.GetClassTypePolymorphic();
-    if (!type.IsSubTypeOf(app::DocumentObjectTopoShape::GetClassType()))
-        return;
-
     app::DocumentObject* part_obj = const_cast<app::DocumentObject*>(&obj);
     auto part = dynamic_cast<app::DocumentObjectTopoShape*>(part_obj);
     m_parts.erase(std::remove(m_parts.begin(), m_parts.end(), part), m_parts.end());
+    RemoveFromIndex(part);
+    SubShapeIndex::GetInstance().Remove(part);
+    FaceAttributeIndex::GetInstance().Remove(part);
+
+    if (m_changed_object_set.erase(&obj))
+        m_changed_objects.erase(std::remove(m_changed_objects.begin(), m_changed_objects.end(), &obj), m_changed_objects.end());
+
+    // 批量中创建又删除的对象尚未通知过，直接丢弃
+    if (m_batch_object_set.erase(&obj))
+    {
+        m_batch_objects.erase(std::remove(m_batch_objects.begin(), m_batch_objects.end(), &obj), m_batch_objects.end());
+        return;
+    }
 
     SignalDeletedObject(obj);
 }
 
 void PartCollection::SlotObjectBeforePropertyChanged(const app::DocumentObject& obj, const app::Property& prop)
 {
-    auto type = obj.GetClassTypePolymorphic();
-    if (!type.IsSubTypeOf(app::DocumentObjectTopoShape::GetClassType()))
-        return;
 }
 
 void PartCollection::SlotObjectPropertyChanged(const app::DocumentObject& obj, const app::Property& prop)
 {
-    auto type = obj.GetClassTypePolymorphic();
-    if (!type.IsSubTypeOf(app::DocumentObjectTopoShape::GetClassType()))
-        return;
+    // 恢复、批量期间也要保持标签索引与属性一致
+    auto part = static_cast<const app::DocumentObjectTopoShape*>(&obj);
+    if (&prop == &obj.Label)
+        UpdateLabelIndex(part);
+    FaceAttributeIndex::GetInstance().OnPropertyChanged(part, prop);
 
-    auto doc = app::GetApplication().GetActiveDocument();
+    auto doc = m_dispatcher->GetDocument();
     if (doc->TestStatus(app::Document::Status::RESTORING))
         return;
 
+    // 批量中新建的对象会在SignalNewObjects时按最新状态整体刷新
+    if (m_batch_object_set.count(&obj))
+        return;
+
+    // 批量期间同一对象的多次变化只记录一次
+    if (IsInBatch())
+    {
+        if (m_changed_object_set.insert(&obj).second)
+            m_changed_objects.push_back(&obj);
+        return;
+    }
+
     SignalObjectPropertyChanged(obj, prop);
 }
 
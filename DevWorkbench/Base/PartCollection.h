@@ -1,9 +1,14 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <boost/signals2.hpp>
 #include <App/DocumentObjectTopoShape.h>
+#include <Base/ObjectSignalDispatcher.h>
 
 namespace app {
 class DocumentObject;
@@ -36,19 +41,68 @@ class PartCollection
     void RemovePart(std::string_view name);
     void RemovePart(app::DocumentObjectTopoShape* obj);
 
+    // 批量模式下新建部件不再逐个发出SignalNewObject，也不转发其属性变化，
+    // 结束时通过SignalNewObjects一次性通知；已有部件的属性变化按对象合并，
+    // 结束时通过SignalObjectsChanged一次性通知。可嵌套
+    void BeginBatch();
+    void EndBatch();
+    bool IsInBatch() const;
+
+    class ScopedBatch
+    {
+      public:
+        explicit ScopedBatch(PartCollection* collection);
+        ~ScopedBatch();
+
+      private:
+        PartCollection* m_collection;
+    };
+
     void SlotNewObject(const app::DocumentObject&);
     void SlotObjectDeleted(const app::DocumentObject&);
     void SlotObjectBeforePropertyChanged(const app::DocumentObject&, const app::Property&);
     void SlotObjectPropertyChanged(const app::DocumentObject&, const app::Property&);
 
     boost::signals2::signal<void(const app::DocumentObject&)> SignalNewObject;
+    boost::signals2::signal<void(const std::vector<const app::DocumentObject*>&)> SignalNewObjects;
     boost::signals2::signal<void(const app::DocumentObject&)> SignalDeletedObject;
     boost::signals2::signal<void(const app::DocumentObject&, const app::Property&)> SignalObjectPropertyChanged;
+    boost::signals2::signal<void(const std::vector<const app::DocumentObject*>&)> SignalObjectsChanged;
+
+  private:
+    void AddToIndex(app::DocumentObjectTopoShape* part);
+    void RemoveFromIndex(app::DocumentObjectTopoShape* part);
+    void UpdateLabelIndex(const app::DocumentObjectTopoShape* part);
+
+    // 支持以string_view直接查找std::string键
+    struct StringHash
+    {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view str) const { return std::hash<std::string_view>{}(str); }
+    };
+    template <typename T>
+    using StringMap = std::unordered_map<std::string, T, StringHash, std::equal_to<>>;
 
   private:
     DevSetup* m_owner;
+    // 只接收部件对象的文档信号
+    std::unique_ptr<ObjectSignalDispatcher> m_dispatcher;
 
     std::vector<app::DocumentObjectTopoShape*> m_parts;
+    // 文档内名称到部件
+    StringMap<app::DocumentObjectTopoShape*> m_name_index;
+    // 标签到使用该标签的部件数量，标签允许重复
+    StringMap<int> m_label_count;
+    // 部件当前登记的标签，标签修改后据此更新m_label_count
+    std::unordered_map<const app::DocumentObjectTopoShape*, std::string> m_part_labels;
+    // GetUniqueName按前缀记录下一个尝试的序号
+    StringMap<int> m_suffix_counters;
+
+    int m_batch_depth;
+    std::vector<const app::DocumentObject*> m_batch_objects;
+    std::unordered_set<const app::DocumentObject*> m_batch_object_set;
+    std::vector<const app::DocumentObject*> m_changed_objects;
+    std::unordered_set<const app::DocumentObject*> m_changed_object_set;
 
     using Connection = boost::signals2::connection;
     Connection connectNewObject;
@@ -0,0 +1,443 @@
+#include "FlatMeshBuilder.h"
+#include <App/Application.h>
+#include <Base/Parameter.h>
+#include <Logging/Logging.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <algorithm>
+#include <cmath>
+#include <common/BoundingBox3.hpp>
+#include <geometry/ComputePointsTangentialDeflection.hpp>
+#include <geometry/Geom3BSplineCurve.hpp>
+#include <geometry/Geom3Curve.hpp>
+#include <math/PolygonOnTriangularMesh.hpp>
+#include <math/TriangularMesh.hpp>
+#include <modeling/CopyShape.hpp>
+#include <modeling/MakeShapeTool.hpp>
+#include <topology/BRepAdaptorCurve3.hpp>
+#include <topology/BRepBoundingBox.hpp>
+#include <topology/TopoEdge.hpp>
+#include <topology/TopoExplorerTool.hpp>
+#include <topology/TopoFace.hpp>
+#include <topology/TopoTool.hpp>
+#include <topology/TopoVertex.hpp>
+#include <topomesh/BRepMeshIncrementalMesh.hpp>
+
+namespace Dev
+{
+    namespace
+    {
+        // 数量较少时串行执行，避免任务调度的开销
+        constexpr std::size_t kParallelGrainSize = 64;
+        // 包围盒无效或退化时边采样的弦高误差下限
+        constexpr double kMinEdgeDeflection = 1.0e-6;
+
+        template <typename Func>
+        void ForEachIndex(std::size_t count, bool parallel, Func &&func)
+        {
+            if (parallel && count > kParallelGrainSize)
+            {
+                tbb::parallel_for(tbb::blocked_range<std::size_t>(0, count, kParallelGrainSize), [&](const tbb::blocked_range<std::size_t> &range)
+                                  {
+                                      for (std::size_t i = range.begin(); i != range.end(); ++i)
+                                          func(i); });
+            }
+            else
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                    func(i);
+            }
+        }
+
+        std::vector<AMCAX::TopoShape> MapShapes(const AMCAX::TopoShape &shape, AMCAX::ShapeType type)
+        {
+            AMCAX::IndexSet<AMCAX::TopoShape> set;
+            AMCAX::TopoExplorerTool::MapShapes(shape, type, set);
+            std::vector<AMCAX::TopoShape> shapes;
+            shapes.reserve(set.size());
+            for (int i = 0; i < set.size(); ++i)
+                shapes.push_back(set[i]);
+            return shapes;
+        }
+
+        void PushPoint(std::vector<double> &out, const AMCAX::Point3 &p)
+        {
+            out.push_back(p.X());
+            out.push_back(p.Y());
+            out.push_back(p.Z());
+        }
+    } // namespace
+
+    FlatMeshBuilder::FlatMeshBuilder(Parameters parameters)
+        : m_parameters(parameters), m_parallel(parameters.parallel)
+    {
+    }
+
+    FlatMeshBuilder::Parameters FlatMeshBuilder::Parameters::ForLevel(MeshLevel level)
+    {
+        Parameters parameters;
+        switch (level)
+        {
+        case MeshLevel::Coarse:
+            parameters.linear_deflection = 0.2;
+            parameters.angular_deflection = 0.6;
+            parameters.isolated = true;
+            parameters.edge_deflection = 0.005;
+            parameters.edge_angular_deflection = 0.3;
+            break;
+        case MeshLevel::Medium:
+            parameters.linear_deflection = 0.05;
+            parameters.angular_deflection = 0.35;
+            parameters.isolated = true;
+            parameters.edge_deflection = 0.002;
+            parameters.edge_angular_deflection = 0.2;
+            break;
+        default:
+            break;
+        }
+        return parameters;
+    }
+
+    void FlatMeshBuilder::SetParallel(bool parallel)
+    {
+        m_parallel = parallel;
+    }
+
+    bool FlatMeshBuilder::IsParallel() const
+    {
+        return m_parallel;
+    }
+
+    bool FlatMeshBuilder::IsParallelEnabled()
+    {
+        auto grp = app::GetApplication().GetUserParameter().GetGroup("BaseApp/Preferences/Mod/Dev/Render");
+        if (!grp)
+            return true;
+        return grp->GetBool("ParallelMesh", true);
+    }
+
+    const FlatMeshBuilder::Parameters &FlatMeshBuilder::GetParameters() const
+    {
+        return m_parameters;
+    }
+
+    FlatMeshInfo FlatMeshBuilder::BuildBoundingBox(const std::string &objId, const AMCAX::TopoShape &shape)
+    {
+        FlatMeshInfo data;
+        data.id = objId;
+        data.category = "SHAPE";
+
+        AMCAX::BoundingBox3 box;
+        AMCAX::BRepBoundingBox::AddToBox(shape, box, false);
+        if (box.IsVoid())
+            return data;
+
+        double bounds[6];
+        box.Get(bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5]);
+        // 角点序号的二进制位依次表示x、y、z取最大值
+        auto corner = [&](int i)
+        {
+            return AMCAX::Point3(bounds[(i & 1) ? 3 : 0], bounds[(i & 2) ? 4 : 1], bounds[(i & 4) ? 5 : 2]);
+        };
+        constexpr int kEdges[12][2] = {{0, 1}, {2, 3}, {4, 5}, {6, 7}, {0, 2}, {1, 3}, {4, 6}, {5, 7}, {0, 4}, {1, 5}, {2, 6}, {3, 7}};
+
+        data.edge_offsets.reserve(13);
+        data.edge_offsets.push_back(0);
+        for (auto const &edge : kEdges)
+        {
+            PushPoint(data.edge_points, corner(edge[0]));
+            PushPoint(data.edge_points, corner(edge[1]));
+            data.edge_offsets.push_back(data.edge_offsets.back() + 2);
+        }
+        return data;
+    }
+
+    FlatMeshInfo FlatMeshBuilder::Build(const std::string &objId,
+                                        const AMCAX::TopoShape &shape,
+                                        bool isVertex,
+                                        bool isEdge,
+                                        bool isFace) const
+    {
+        FlatMeshInfo data;
+        data.id = objId;
+
+        AMCAX::TopoShape target = shape;
+        auto shapeVerts = MapShapes(target, AMCAX::ShapeType::Vertex);
+        auto shapeEdges = MapShapes(target, AMCAX::ShapeType::Edge);
+        auto shapeFaces = MapShapes(target, AMCAX::ShapeType::Face);
+
+        bool isPoint = shapeFaces.empty() && shapeEdges.empty();
+        bool isCurve = shapeFaces.empty() && !shapeEdges.empty();
+
+        if (!shapeFaces.empty())
+        {
+            // 副本共享几何但不带三角网格，遍历顺序与原形状一致，面、边的序号保持对应
+            if (m_parameters.isolated)
+            {
+                target = AMCAX::CopyShape(shape, false, false).Shape();
+                shapeVerts = MapShapes(target, AMCAX::ShapeType::Vertex);
+                shapeEdges = MapShapes(target, AMCAX::ShapeType::Edge);
+                shapeFaces = MapShapes(target, AMCAX::ShapeType::Face);
+            }
+            if (!EnsureTriangulation(objId, target, shapeFaces.front()))
+                return data;
+        }
+        AMCAX::MakeShapeTool::EnsureNormalConsistency(target);
+
+        if (isPoint)
+        {
+            data.category = "POINT";
+            data.points.reserve(shapeVerts.size() * 3);
+            for (auto const &v : shapeVerts)
+                PushPoint(data.points, AMCAX::TopoTool::Point(static_cast<const AMCAX::TopoVertex &>(v)));
+            return data;
+        }
+
+        data.category = "SHAPE";
+
+        if (isVertex)
+        {
+            data.vertices.reserve(shapeVerts.size() * 3);
+            for (auto const &v : shapeVerts)
+                PushPoint(data.vertices, AMCAX::TopoTool::Point(static_cast<const AMCAX::TopoVertex &>(v)));
+        }
+
+        // 先生成面，使边可以引用面顶点
+        if (isFace)
+            BuildFaces(shapeFaces, data);
+
+        if (isEdge)
+        {
+            FaceVertexBase faceBase;
+            bool indexed = isFace && m_parameters.indexed_edges && !shapeFaces.empty();
+            if (indexed)
+                faceBase = IndexFaceVertices(shapeFaces, data);
+            BuildEdges(shapeEdges, isCurve, ComputeEdgeDeflection(target), indexed ? &faceBase : nullptr, data);
+        }
+
+        return data;
+    }
+
+    bool FlatMeshBuilder::EnsureTriangulation(const std::string &objId, const AMCAX::TopoShape &shape, const AMCAX::TopoShape &first_face) const
+    {
+        AMCAX::TopoLocation location;
+        auto mesh = AMCAX::TopoTool::Triangulation(static_cast<const AMCAX::TopoFace &>(first_face), location);
+        if (mesh)
+            return true;
+
+        AMCAX::BRepMeshIncrementalMesh IMesh(shape, m_parameters.linear_deflection, m_parameters.relative, m_parameters.angular_deflection);
+        if (!IMesh.IsDone())
+        {
+            LOGGING_DEBUG << objId << " :updateRenderData BRepMeshIncrementalMesh not Done";
+            return false;
+        }
+        return true;
+    }
+
+    double FlatMeshBuilder::ComputeEdgeDeflection(const AMCAX::TopoShape &shape) const
+    {
+        AMCAX::BoundingBox3 box;
+        AMCAX::BRepBoundingBox::AddToBox(shape, box, false);
+        if (box.IsVoid())
+            return kMinEdgeDeflection;
+        double diagonal = box.CornerMin().Distance(box.CornerMax());
+        return std::max(diagonal * m_parameters.edge_deflection, kMinEdgeDeflection);
+    }
+
+    FlatMeshBuilder::FaceVertexBase FlatMeshBuilder::IndexFaceVertices(const std::vector<AMCAX::TopoShape> &faces, const FlatMeshInfo &data)
+    {
+        FaceVertexBase faceBase;
+        std::unordered_map<const AMCAX::TriangularMesh *, int> useCount;
+        for (std::size_t i = 0; i < faces.size(); ++i)
+        {
+            AMCAX::TopoLocation loc;
+            auto mesh = AMCAX::TopoTool::Triangulation(static_cast<const AMCAX::TopoFace &>(faces[i]), loc);
+            if (!mesh)
+                continue;
+            faceBase[mesh.get()] = data.face_point_offsets[i];
+            ++useCount[mesh.get()];
+        }
+        // 共用的三角网格无法确定边属于哪个面的顶点区间，这些边退回坐标形式
+        for (auto const &[mesh, count] : useCount)
+        {
+            if (count > 1)
+                faceBase.erase(mesh);
+        }
+        return faceBase;
+    }
+
+    void FlatMeshBuilder::BuildEdges(const std::vector<AMCAX::TopoShape> &edges,
+                                     bool isCurve,
+                                     double deflection,
+                                     const FaceVertexBase *faceBase,
+                                     FlatMeshInfo &data) const
+    {
+        // 每条边的采样点数事先未知，先各自生成折线块，再按前缀和偏移拼接
+        struct EdgeChunk
+        {
+            std::vector<double> points;
+            std::vector<std::uint32_t> indices;
+        };
+        std::vector<EdgeChunk> chunks(edges.size());
+        ForEachIndex(edges.size(), m_parallel, [&](std::size_t i)
+                     { SampleEdge(edges[i], isCurve, deflection, faceBase, chunks[i].points, chunks[i].indices); });
+
+        data.edge_offsets.resize(edges.size() + 1, 0);
+        for (std::size_t i = 0; i < edges.size(); ++i)
+            data.edge_offsets[i + 1] = data.edge_offsets[i] + static_cast<std::uint32_t>(chunks[i].points.size() / 3);
+
+        data.edge_points.resize(static_cast<std::size_t>(data.edge_offsets.back()) * 3);
+        ForEachIndex(edges.size(), m_parallel, [&](std::size_t i)
+                     { std::copy(chunks[i].points.begin(), chunks[i].points.end(), data.edge_points.begin() + static_cast<std::size_t>(data.edge_offsets[i]) * 3); });
+
+        if (!faceBase)
+            return;
+
+        data.edge_index_offsets.resize(edges.size() + 1, 0);
+        for (std::size_t i = 0; i < edges.size(); ++i)
+            data.edge_index_offsets[i + 1] = data.edge_index_offsets[i] + static_cast<std::uint32_t>(chunks[i].indices.size());
+        if (data.edge_index_offsets.back() == 0)
+        {
+            data.edge_index_offsets.clear();
+            return;
+        }
+
+        data.edge_indices.resize(data.edge_index_offsets.back());
+        ForEachIndex(edges.size(), m_parallel, [&](std::size_t i)
+                     { std::copy(chunks[i].indices.begin(), chunks[i].indices.end(), data.edge_indices.begin() + data.edge_index_offsets[i]); });
+    }
+
+    bool FlatMeshBuilder::SampleEdge(const AMCAX::TopoShape &edge,
+                                     bool isCurve,
+                                     double deflection,
+                                     const FaceVertexBase *faceBase,
+                                     std::vector<double> &points,
+                                     std::vector<std::uint32_t> &indices) const
+    {
+        const AMCAX::TopoEdge &aEdge = static_cast<const AMCAX::TopoEdge &>(edge);
+
+        if (!isCurve)
+        {
+            std::shared_ptr<AMCAX::PolygonOnTriangularMesh> poly;
+            std::shared_ptr<AMCAX::TriangularMesh> mesh;
+            AMCAX::TopoLocation loc;
+            AMCAX::TopoTool::PolygonOnTriangulation(aEdge, poly, mesh, loc);
+            if (poly)
+            {
+                if (faceBase)
+                {
+                    auto base = faceBase->find(mesh.get());
+                    if (base != faceBase->end())
+                    {
+                        indices.reserve(indices.size() + poly->NVertices());
+                        for (int pid = 0; pid < poly->NVertices(); ++pid)
+                            indices.push_back(base->second + static_cast<std::uint32_t>(poly->Vertex(pid)));
+                        return true;
+                    }
+                }
+
+                AMCAX::Transformation3 tr = loc.Transformation();
+                points.reserve(points.size() + poly->NVertices() * 3);
+                for (int pid = 0; pid < poly->NVertices(); ++pid)
+                    PushPoint(points, mesh->Vertex(poly->Vertex(pid)).Transformed(tr));
+                return false;
+            }
+        }
+
+        // 按弦高与角度误差自适应采样，平直的曲线只需少量点。
+        // 样条至少在每个节点区间取一个点，避免跳过节点间的局部起伏
+        AMCAX::BRepAdaptorCurve3 ad(aEdge);
+        int minPoints = 2;
+        double angulardef = m_parameters.edge_angular_deflection;
+        if (ad.Type() == AMCAX::CurveType::BSplineCurve)
+        {
+            minPoints = std::max(minPoints, ad.BSpline()->NKnots());
+            if (isCurve)
+                angulardef /= 2;
+        }
+        AMCAX::ComputePointsTangentialDeflection smart(ad, angulardef, deflection, minPoints);
+        points.reserve(points.size() + smart.NPoints() * 3);
+        for (int i = 0; i < smart.NPoints(); i++)
+            PushPoint(points, smart.Value(i));
+        return false;
+    }
+
+    void FlatMeshBuilder::BuildFaces(const std::vector<AMCAX::TopoShape> &faces, FlatMeshInfo &data) const
+    {
+        struct FaceMesh
+        {
+            std::shared_ptr<AMCAX::TriangularMesh> triMesh;
+            AMCAX::TopoLocation loc;
+            bool reversed = false;
+        };
+
+        // 先统计每个面的顶点与三角形数量，得到各面在连续数组中的偏移
+        std::vector<FaceMesh> meshes(faces.size());
+        ForEachIndex(faces.size(), m_parallel, [&](std::size_t i)
+                     {
+                         const AMCAX::TopoFace &f = static_cast<const AMCAX::TopoFace &>(faces[i]);
+                         meshes[i].triMesh = AMCAX::TopoTool::Triangulation(f, meshes[i].loc);
+                         meshes[i].reversed = f.Orientation() == AMCAX::OrientationType::Reversed; });
+
+        data.face_point_offsets.resize(faces.size() + 1, 0);
+        data.face_facet_offsets.resize(faces.size() + 1, 0);
+        for (std::size_t i = 0; i < faces.size(); ++i)
+        {
+            std::uint32_t nVertices = meshes[i].triMesh ? meshes[i].triMesh->NVertices() : 0;
+            std::uint32_t nTriangles = meshes[i].triMesh ? meshes[i].triMesh->NTriangles() : 0;
+            data.face_point_offsets[i + 1] = data.face_point_offsets[i] + nVertices;
+            data.face_facet_offsets[i + 1] = data.face_facet_offsets[i] + nTriangles;
+        }
+
+        data.points.resize(static_cast<std::size_t>(data.face_point_offsets.back()) * 3);
+        data.normals.resize(data.points.size());
+        data.facets.resize(static_cast<std::size_t>(data.face_facet_offsets.back()) * 3);
+
+        // 各面写入互不重叠的区间，可并发执行
+        ForEachIndex(faces.size(), m_parallel, [&](std::size_t i)
+                     {
+            auto const &mesh = meshes[i].triMesh;
+            if (!mesh)
+                return;
+
+            AMCAX::Transformation3 tr = meshes[i].loc.Transformation();
+            std::uint32_t baseVerticeIndex = data.face_point_offsets[i];
+            double *points = data.points.data() + static_cast<std::size_t>(baseVerticeIndex) * 3;
+            double *normals = data.normals.data() + static_cast<std::size_t>(baseVerticeIndex) * 3;
+            std::uint32_t *facets = data.facets.data() + static_cast<std::size_t>(data.face_facet_offsets[i]) * 3;
+
+            bool hasNormals = mesh->HasNormals();
+            double sign = meshes[i].reversed ? -1.0 : 1.0;
+            for (int vid = 0; vid < mesh->NVertices(); ++vid)
+            {
+                const AMCAX::Point3 &p = mesh->Vertex(vid).Transformed(tr);
+                *points++ = p.X();
+                *points++ = p.Y();
+                *points++ = p.Z();
+                if (hasNormals)
+                {
+                    const AMCAX::Direction3 &norm = mesh->Normal(vid).Transformed(tr);
+                    *normals++ = sign * norm.X();
+                    *normals++ = sign * norm.Y();
+                    *normals++ = sign * norm.Z();
+                }
+                else
+                {
+                    *normals++ = 0.0;
+                    *normals++ = 0.0;
+                    *normals++ = 1.0;
+                }
+            }
+
+            for (int fid = 0; fid < mesh->NTriangles(); ++fid)
+            {
+                AMCAX::Triangle tri = mesh->Face(fid);
+                if (meshes[i].reversed)
+                    std::swap(tri[1], tri[2]);
+                *facets++ = static_cast<std::uint32_t>(tri[0]) + baseVerticeIndex;
+                *facets++ = static_cast<std::uint32_t>(tri[1]) + baseVerticeIndex;
+                *facets++ = static_cast<std::uint32_t>(tri[2]) + baseVerticeIndex;
+            } });
+    }
+
+} // namespace Dev
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <Base/Render/FlatMeshInfo.h>
+#include <topology/TopoShape.hpp>
+
+namespace AMCAX {
+class TriangularMesh;
+}
+
+namespace Dev {
+
+/**
+ * @brief 由TopoShape生成FlatMeshInfo
+ *
+ * 处理流程与gui::RenderDataHelper::parseShapeToData一致（网格化、点、边、面），
+ * 但先统计各面的顶点与三角形数量，再一次性写入连续数组。
+ * 并行模式下各面、各边的提取由TBB并发执行，面按前缀和得到的baseVerticeIndex直接写入各自的区间，
+ * 边先生成各自的折线块再按偏移拼接，结果与串行模式完全一致。
+ */
+class FlatMeshBuilder
+{
+  public:
+    // 细节层次，由粗到细
+    enum class MeshLevel
+    {
+        Coarse = 0,
+        Medium,
+        Fine,
+        Count
+    };
+
+    // 网格化参数，语义同BRepMeshIncrementalMesh
+    struct Parameters
+    {
+        double linear_deflection = 0.01;
+        bool relative = true;
+        double angular_deflection = 0.2;
+        // 在形状的拓扑副本上网格化，不改变原形状已有的三角网格（较粗的层次使用）
+        bool isolated = false;
+        // 边折线采样的弦高误差，相对于形状包围盒对角线长度
+        double edge_deflection = 0.0005;
+        // 边折线采样的角度误差（弧度）
+        double edge_angular_deflection = 0.1;
+        // 边在三角网格上有折线时以面顶点序号表示，与面共用顶点数组
+        bool indexed_edges = true;
+        // 以下两项不影响生成结果，由调用者在GUI线程读取用户参数后填入，工作线程不访问参数树
+        // 是否并行提取各面、各边
+        bool parallel = true;
+        // 是否经过TessellationCache读写磁盘缓存，开启前需在GUI线程构造缓存实例
+        bool disk_cache = false;
+
+        static Parameters ForLevel(MeshLevel level);
+    };
+
+    explicit FlatMeshBuilder(Parameters parameters = Parameters());
+
+    // 是否并行提取，初始值为Parameters::parallel
+    void SetParallel(bool parallel);
+    bool IsParallel() const;
+    // 用户参数 BaseApp/Preferences/Mod/Dev/Render/ParallelMesh，只在GUI线程调用
+    static bool IsParallelEnabled();
+
+    FlatMeshInfo Build(const std::string& objId,
+                       const AMCAX::TopoShape& shape,
+                       bool isVertex = true,
+                       bool isEdge = true,
+                       bool isFace = true) const;
+
+    const Parameters& GetParameters() const;
+
+    // 只含包围盒12条棱线的网格，用于网格生成完成前的占位显示
+    static FlatMeshInfo BuildBoundingBox(const std::string& objId, const AMCAX::TopoShape& shape);
+
+  private:
+    bool EnsureTriangulation(const std::string& objId, const AMCAX::TopoShape& shape, const AMCAX::TopoShape& first_face) const;
+
+    // 由包围盒得到边折线采样的绝对弦高误差
+    double ComputeEdgeDeflection(const AMCAX::TopoShape& shape) const;
+
+    // 三角网格到所属面第一个顶点在points中的全局序号，被多个面共用的三角网格不在其中
+    using FaceVertexBase = std::unordered_map<const AMCAX::TriangularMesh*, std::uint32_t>;
+
+    void BuildEdges(const std::vector<AMCAX::TopoShape>& edges,
+                    bool isCurve,
+                    double deflection,
+                    const FaceVertexBase* faceBase,
+                    FlatMeshInfo& data) const;
+    void BuildFaces(const std::vector<AMCAX::TopoShape>& faces, FlatMeshInfo& data) const;
+    static FaceVertexBase IndexFaceVertices(const std::vector<AMCAX::TopoShape>& faces, const FlatMeshInfo& data);
+
+    // 生成单条边的折线。能引用面顶点时把全局序号追加到indices并返回true，
+    // 否则把坐标追加到points，没有三角网格上的折线时按曲率自适应采样
+    bool SampleEdge(const AMCAX::TopoShape& edge,
+                    bool isCurve,
+                    double deflection,
+                    const FaceVertexBase* faceBase,
+                    std::vector<double>& points,
+                    std::vector<std::uint32_t>& indices) const;
+
+  private:
+    Parameters m_parameters;
+    bool m_parallel;
+};
+
+}  // namespace Dev
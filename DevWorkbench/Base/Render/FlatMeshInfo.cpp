@@ -0,0 +1,112 @@
+#include "FlatMeshInfo.h"
+#include <algorithm>
+
+namespace Dev
+{
+    namespace
+    {
+        template <typename T>
+        std::size_t CapacityBytes(const std::vector<T> &vec)
+        {
+            return vec.capacity() * sizeof(T);
+        }
+    } // namespace
+
+    std::size_t FlatMeshInfo::MemorySize() const
+    {
+        return CapacityBytes(points) + CapacityBytes(normals) + CapacityBytes(facets) +
+               CapacityBytes(face_point_offsets) + CapacityBytes(face_facet_offsets) +
+               CapacityBytes(vertices) + CapacityBytes(edge_points) + CapacityBytes(edge_offsets) +
+               CapacityBytes(edge_indices) + CapacityBytes(edge_index_offsets) +
+               category.capacity() + id.capacity();
+    }
+
+    bool FlatMeshInfo::GetBoundingBox(double bounds[6]) const
+    {
+        bool found = false;
+        auto expand = [&](const std::vector<double> &coords)
+        {
+            for (std::size_t i = 0; i + 2 < coords.size(); i += 3)
+            {
+                if (!found)
+                {
+                    for (int k = 0; k < 3; ++k)
+                        bounds[k] = bounds[k + 3] = coords[i + k];
+                    found = true;
+                    continue;
+                }
+                for (int k = 0; k < 3; ++k)
+                {
+                    bounds[k] = std::min(bounds[k], coords[i + k]);
+                    bounds[k + 3] = std::max(bounds[k + 3], coords[i + k]);
+                }
+            }
+        };
+        expand(points);
+        expand(vertices);
+        expand(edge_points);
+        return found;
+    }
+
+    void FlatMeshInfo::Clear()
+    {
+        category.clear();
+        points.clear();
+        normals.clear();
+        facets.clear();
+        face_point_offsets.clear();
+        face_facet_offsets.clear();
+        vertices.clear();
+        edge_points.clear();
+        edge_offsets.clear();
+        edge_indices.clear();
+        edge_index_offsets.clear();
+    }
+
+    AMCAXRender::CAXMeshInfo FlatMeshInfo::ToCAXMeshInfo() const
+    {
+        AMCAXRender::CAXMeshInfo data;
+        data.category = category;
+        data.id = id;
+
+        data.points.reserve(PointCount());
+        for (std::size_t i = 0; i + 2 < points.size(); i += 3)
+            data.points.emplace_back(points.begin() + i, points.begin() + i + 3);
+
+        if (category == "POINT")
+            return data;
+
+        data.normals.reserve(normals.size() / 3);
+        for (std::size_t i = 0; i + 2 < normals.size(); i += 3)
+            data.normals.emplace_back(normals.begin() + i, normals.begin() + i + 3);
+
+        data.vertex.topoType = "point";
+        data.vertex.vertices.assign(vertices.begin(), vertices.end());
+
+        data.edges.resize(EdgeCount());
+        for (std::size_t i = 0; i < data.edges.size(); ++i)
+        {
+            auto &eitem = data.edges[i];
+            if (IsEdgeIndexed(i))
+            {
+                eitem.meshType = "index";
+                eitem.mesh.assign(edge_indices.begin() + edge_index_offsets[i], edge_indices.begin() + edge_index_offsets[i + 1]);
+                continue;
+            }
+            eitem.meshType = "point";
+            eitem.mesh.assign(edge_points.begin() + edge_offsets[i] * 3, edge_points.begin() + edge_offsets[i + 1] * 3);
+        }
+
+        data.faces.resize(FaceCount());
+        for (std::size_t i = 0; i < data.faces.size(); ++i)
+        {
+            auto &fitem = data.faces[i];
+            fitem.pointSize = static_cast<int>(face_point_offsets[i + 1] - face_point_offsets[i]);
+            fitem.facets.reserve(face_facet_offsets[i + 1] - face_facet_offsets[i]);
+            for (std::uint32_t t = face_facet_offsets[i]; t < face_facet_offsets[i + 1]; ++t)
+                fitem.facets.emplace_back(facets.begin() + t * 3, facets.begin() + t * 3 + 3);
+        }
+        return data;
+    }
+
+} // namespace Dev
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <AMCAXRender.h>
+
+namespace Dev {
+
+/**
+ * @brief 连续内存的网格数据（SoA布局）
+ *
+ * 与AMCAXRender::CAXMeshInfo表达同样的内容，但所有点、法向和三角形索引都存放在一维数组中，
+ * 每个面、每条边在数组中的范围由偏移表给出，避免逐点、逐三角形的小块内存分配。
+ * 坐标与法向使用double存储，与CAXMeshInfo一致，转换时直接拷贝，不损失精度。
+ */
+struct FlatMeshInfo
+{
+    std::string category;  // "SHAPE" / "POINT"
+    std::string id;
+
+    // 面网格：所有面的顶点依次排列，POINT类型时为拓扑点
+    std::vector<double> points;   // x,y,z
+    std::vector<double> normals;  // x,y,z，与points一一对应
+    // 三角形顶点索引（全局），每3个为一个三角形
+    std::vector<std::uint32_t> facets;
+    // 第i个面的顶点为[face_point_offsets[i], face_point_offsets[i+1])，大小为面数+1
+    std::vector<std::uint32_t> face_point_offsets;
+    // 第i个面的三角形为[face_facet_offsets[i], face_facet_offsets[i+1])，大小为面数+1
+    std::vector<std::uint32_t> face_facet_offsets;
+
+    // 拓扑点
+    std::vector<double> vertices;  // x,y,z
+
+    // 边折线：第i条边的点为[edge_offsets[i], edge_offsets[i+1])，大小为边数+1
+    std::vector<double> edge_points;  // x,y,z
+    std::vector<std::uint32_t> edge_offsets;
+    // 索引形式的边折线：第i条边引用的面顶点（points中的全局序号）为
+    // [edge_index_offsets[i], edge_index_offsets[i+1])，为空表示所有边都是坐标形式。
+    // 每条边只使用坐标与索引两种形式之一
+    std::vector<std::uint32_t> edge_indices;
+    std::vector<std::uint32_t> edge_index_offsets;
+
+    std::size_t PointCount() const { return points.size() / 3; }
+    std::size_t TriangleCount() const { return facets.size() / 3; }
+    std::size_t FaceCount() const { return face_point_offsets.empty() ? 0 : face_point_offsets.size() - 1; }
+    std::size_t EdgeCount() const { return edge_offsets.empty() ? 0 : edge_offsets.size() - 1; }
+
+    bool IsEdgeIndexed(std::size_t i) const
+    {
+        return !edge_index_offsets.empty() && edge_index_offsets[i + 1] > edge_index_offsets[i];
+    }
+
+    bool IsEmpty() const { return points.empty() && vertices.empty() && edge_points.empty(); }
+
+    // 所有点（面、拓扑点、边）的包围盒，依次为xmin,ymin,zmin,xmax,ymax,zmax，为空时返回false
+    bool GetBoundingBox(double bounds[6]) const;
+
+    // 占用的堆内存字节数
+    std::size_t MemorySize() const;
+
+    void Clear();
+
+    // 转换为渲染接口所需的结构，仅在提交给渲染端时使用。拓扑点与边折线整段拷贝，
+    // 点、法向与三角形按接口要求逐个生成小数组，事先按数量预留容量。
+    // SlimTriangleMeshInfo不带面、边的拓扑信息，无法用于拾取与边显示，因此不提供该转换
+    AMCAXRender::CAXMeshInfo ToCAXMeshInfo() const;
+};
+
+}  // namespace Dev
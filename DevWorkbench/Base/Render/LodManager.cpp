@@ -0,0 +1,219 @@
+#include "LodManager.h"
+#include <App/Application.h>
+#include <Base/Import/ImportGuard.h>
+#include <Base/Parameter.h>
+#include <Base/ViewProvider/ViewProviderPart.h>
+#include <Gui/MainWindow.h>
+#include <AMCAXRender.h>
+#include <QTimer>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace Dev
+{
+    namespace
+    {
+        // 检查相机的间隔
+        constexpr int kTimerInterval = 150;
+        // 包围盒占视口高度的比例阈值：低于第一个为粗，低于第二个为中，其余为细
+        constexpr double kLevelThresholds[] = {0.05, 0.2};
+        // 阈值附近的回滞系数
+        constexpr double kHysteresis = 1.2;
+        constexpr double kPi = 3.14159265358979323846;
+    } // namespace
+
+    bool LodManager::CameraState::operator==(const CameraState &other) const
+    {
+        return std::equal(position, position + 3, other.position) &&
+               std::equal(focal_point, focal_point + 3, other.focal_point) &&
+               parallel == other.parallel && view_angle == other.view_angle &&
+               parallel_scale == other.parallel_scale;
+    }
+
+    LodManager &LodManager::GetInstance()
+    {
+        static LodManager instance;
+        return instance;
+    }
+
+    LodManager::LodManager()
+        : m_timer(nullptr)
+    {
+    }
+
+    bool LodManager::IsEnabled()
+    {
+        auto grp = app::GetApplication().GetUserParameter().GetGroup("BaseApp/Preferences/Mod/Dev/Render");
+        if (!grp)
+            return true;
+        return grp->GetBool("LevelOfDetail", true);
+    }
+
+    void LodManager::Register(ViewProviderPart *part)
+    {
+        m_parts.insert(part);
+        EnsureTimer();
+    }
+
+    void LodManager::Unregister(ViewProviderPart *part)
+    {
+        m_parts.erase(part);
+        m_dirty.erase(part);
+        m_pending.erase(part);
+    }
+
+    void LodManager::RequestUpdate(ViewProviderPart *part)
+    {
+        if (m_parts.count(part))
+            m_dirty.insert(part);
+    }
+
+    void LodManager::RequestRender(ViewProviderPart *part)
+    {
+        if (m_parts.count(part))
+            m_pending.insert(part);
+    }
+
+    void LodManager::UpdatePendingRenders()
+    {
+        for (auto it = m_pending.begin(); it != m_pending.end();)
+        {
+            if ((*it)->UpdatePendingRender())
+                it = m_pending.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    void LodManager::EnsureTimer()
+    {
+        if (m_timer)
+            return;
+        // 以主窗口为父对象，随主窗口一起释放
+        m_timer = new QTimer(gui::GetMainWindow());
+        m_timer->setInterval(kTimerInterval);
+        QObject::connect(m_timer, &QTimer::timeout, [this]()
+                         { OnTimer(); });
+        QObject::connect(m_timer, &QObject::destroyed, [this]()
+                         { m_timer = nullptr; });
+        m_timer->start();
+    }
+
+    LodManager::MeshLevel LodManager::SelectLevel(double fraction, MeshLevel current)
+    {
+        int level = 0;
+        for (double threshold : kLevelThresholds)
+        {
+            if (fraction >= threshold)
+                ++level;
+        }
+
+        // 与当前层次相邻时，只有越过阈值一定幅度才切换
+        int cur = static_cast<int>(current);
+        if (level == cur + 1 && fraction < kLevelThresholds[cur] * kHysteresis)
+            level = cur;
+        else if (level == cur - 1 && fraction > kLevelThresholds[level] / kHysteresis)
+            level = cur;
+        return static_cast<MeshLevel>(level);
+    }
+
+    double LodManager::ComputeScreenFraction(const double bounds[6], const CameraState &camera)
+    {
+        double center[3], radius = 0.0;
+        for (int k = 0; k < 3; ++k)
+        {
+            center[k] = (bounds[k] + bounds[k + 3]) / 2.0;
+            double half = (bounds[k + 3] - bounds[k]) / 2.0;
+            radius += half * half;
+        }
+        radius = std::sqrt(radius);
+
+        if (camera.parallel)
+            return camera.parallel_scale > 0 ? radius / camera.parallel_scale : 1.0;
+
+        double distance = 0.0;
+        for (int k = 0; k < 3; ++k)
+            distance += (center[k] - camera.position[k]) * (center[k] - camera.position[k]);
+        distance = std::sqrt(distance);
+        if (distance <= radius || camera.view_angle <= 0)
+            return 1.0;
+
+        double angle = 2.0 * std::asin(radius / distance) * 180.0 / kPi;
+        return angle / camera.view_angle;
+    }
+
+    LodManager::CameraState LodManager::ReadCamera(AMCAXRender::CBasicRender &render)
+    {
+        CameraState state;
+        auto camera = render.cameraManage;
+        if (!camera)
+            return state;
+        camera->GetPosition(state.position[0], state.position[1], state.position[2]);
+        camera->GetFocalPoint(state.focal_point[0], state.focal_point[1], state.focal_point[2]);
+        camera->GetParallelProjection(state.parallel);
+        state.view_angle = camera->GetViewAngle();
+        state.parallel_scale = camera->GetParallelScale();
+        return state;
+    }
+
+    void LodManager::OnTimer()
+    {
+        // 导入事务中途不同步生成网格，导入结束后的下一次检查再处理
+        if (ImportGuard::IsActive())
+            return;
+        // 与细节层次开关无关，打开的文档关联视图后都要生成网格
+        UpdatePendingRenders();
+        if (m_parts.empty() || !IsEnabled())
+            return;
+
+        std::unordered_map<AMCAXRender::CBasicRender *, CameraState> cameras;
+        for (auto part : m_parts)
+        {
+            auto render = part->GetRenderView();
+            if (render && !cameras.count(render.get()))
+                cameras.emplace(render.get(), ReadCamera(*render));
+        }
+        bool camera_changed = cameras != m_cameras;
+        m_cameras = std::move(cameras);
+        if (!camera_changed && m_dirty.empty())
+            return;
+
+        struct Candidate
+        {
+            ViewProviderPart *part;
+            double fraction;
+            MeshLevel level;
+        };
+        std::vector<Candidate> candidates;
+        auto evaluate = [&](ViewProviderPart *part)
+        {
+            auto render = part->GetRenderView();
+            double bounds[6];
+            if (!render || !part->Visibility.GetValue() || !part->GetBoundingBox(bounds))
+                return;
+            double fraction = ComputeScreenFraction(bounds, m_cameras[render.get()]);
+            MeshLevel level = SelectLevel(fraction, part->GetCurrentLevel());
+            if (level != part->GetCurrentLevel())
+                candidates.push_back({part, fraction, level});
+        };
+        if (camera_changed)
+        {
+            for (auto part : m_parts)
+                evaluate(part);
+        }
+        else
+        {
+            for (auto part : m_dirty)
+                evaluate(part);
+        }
+        m_dirty.clear();
+
+        // 网格在后台生成，投影大的部件先提交
+        std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b)
+                         { return a.fraction > b.fraction; });
+        for (auto const &candidate : candidates)
+            candidate.part->SetLevel(candidate.level);
+    }
+
+} // namespace Dev
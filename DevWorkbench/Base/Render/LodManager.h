@@ -0,0 +1,74 @@
+#pragma once
+
+#include <unordered_map>
+#include <unordered_set>
+#include <Base/Render/FlatMeshBuilder.h>
+
+class QTimer;
+
+namespace AMCAXRender {
+class CBasicRender;
+}
+
+namespace Dev {
+
+class ViewProviderPart;
+
+/**
+ * @brief 细节层次切换
+ *
+ * 定时检查各视图的相机，相机变化后按部件包围盒在视口中的投影大小为每个部件选择层次。
+ * 层次变化的部件按投影从大到小提交后台生成，完成前继续显示原来的层次，
+ * 导航过程中GUI线程不生成网格。
+ * 打开文档时部件的形状先于视图恢复，同一定时器在视图关联后为这些部件生成网格。
+ */
+class LodManager
+{
+  public:
+    using MeshLevel = FlatMeshBuilder::MeshLevel;
+
+    struct CameraState
+    {
+        double position[3] = {0, 0, 0};
+        double focal_point[3] = {0, 0, 0};
+        bool parallel = false;
+        double view_angle = 30.0;
+        double parallel_scale = 1.0;
+
+        bool operator==(const CameraState& other) const;
+        bool operator!=(const CameraState& other) const { return !(*this == other); }
+    };
+
+    static LodManager& GetInstance();
+
+    // 用户参数 BaseApp/Preferences/Mod/Dev/Render/LevelOfDetail
+    static bool IsEnabled();
+
+    void Register(ViewProviderPart* part);
+    void Unregister(ViewProviderPart* part);
+    // 部件形状变化后请求重新选择层次
+    void RequestUpdate(ViewProviderPart* part);
+    // 形状更新时部件尚未关联视图，关联后调用其UpdatePendingRender
+    void RequestRender(ViewProviderPart* part);
+
+    // fraction为包围盒在视口高度中所占比例，current用于避免在阈值附近来回切换
+    static MeshLevel SelectLevel(double fraction, MeshLevel current);
+    static double ComputeScreenFraction(const double bounds[6], const CameraState& camera);
+
+  private:
+    LodManager();
+
+    void EnsureTimer();
+    void OnTimer();
+    void UpdatePendingRenders();
+    static CameraState ReadCamera(AMCAXRender::CBasicRender& render);
+
+  private:
+    QTimer* m_timer;
+    std::unordered_set<ViewProviderPart*> m_parts;
+    std::unordered_set<ViewProviderPart*> m_dirty;
+    std::unordered_set<ViewProviderPart*> m_pending;
+    std::unordered_map<AMCAXRender::CBasicRender*, CameraState> m_cameras;
+};
+
+}  // namespace Dev
@@ -0,0 +1,397 @@
+#include "TessellationCache.h"
+#include <App/Application.h>
+#include <Base/Parameter.h>
+#include <Logging/Logging.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <streambuf>
+#include <thread>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <occtio/OCCTTool.hpp>
+
+namespace Dev
+{
+    namespace
+    {
+        // 文件格式或网格生成逻辑变化时递增，使旧缓存失效
+        constexpr std::uint32_t kCacheVersion = 4;
+        constexpr char kCacheMagic[8] = {'D', 'E', 'V', 'M', 'E', 'S', 'H', '\0'};
+        constexpr std::uintmax_t kDefaultCacheSizeMB = 2048;
+        // 内存中键记录数超过该值时清除TShape已销毁的记录
+        constexpr std::size_t kMemoPruneSize = 4096;
+
+        enum ArrayIndex
+        {
+            POINTS = 0,
+            NORMALS,
+            FACETS,
+            FACE_POINT_OFFSETS,
+            FACE_FACET_OFFSETS,
+            VERTICES,
+            EDGE_POINTS,
+            EDGE_OFFSETS,
+            EDGE_INDICES,
+            EDGE_INDEX_OFFSETS,
+            ARRAY_COUNT
+        };
+
+        struct FileHeader
+        {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t category;  // 0: SHAPE, 1: POINT
+            std::uint64_t sizes[ARRAY_COUNT];
+        };
+        static_assert(sizeof(FileHeader) % 8 == 0);
+
+        std::size_t Align8(std::size_t size)
+        {
+            return (size + 7) & ~std::size_t(7);
+        }
+
+        /**
+         * 边写边计算两个独立的64位哈希（FNV-1a及其带移位混合的变体），避免把整个BRep文本放入内存
+         */
+        class HashStreamBuf : public std::streambuf
+        {
+          public:
+            std::uint64_t h1 = 14695981039346656037ull;
+            std::uint64_t h2 = 0x84222325cbf29ce4ull;
+            std::uint64_t length = 0;
+
+            void Update(const char *data, std::size_t size)
+            {
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    auto c = static_cast<unsigned char>(data[i]);
+                    h1 = (h1 ^ c) * 1099511628211ull;
+                    h2 = (h2 ^ c) * 0x100000001b3ull;
+                    h2 ^= h2 >> 29;
+                }
+                length += size;
+            }
+
+          protected:
+            int_type overflow(int_type ch) override
+            {
+                if (ch != traits_type::eof())
+                {
+                    char c = static_cast<char>(ch);
+                    Update(&c, 1);
+                }
+                return ch;
+            }
+
+            std::streamsize xsputn(const char *s, std::streamsize count) override
+            {
+                Update(s, static_cast<std::size_t>(count));
+                return count;
+            }
+        };
+
+        template <typename T>
+        void WriteArray(std::ofstream &ofs, const std::vector<T> &vec)
+        {
+            static const char padding[8] = {};
+            std::size_t bytes = vec.size() * sizeof(T);
+            if (bytes)
+                ofs.write(reinterpret_cast<const char *>(vec.data()), static_cast<std::streamsize>(bytes));
+            ofs.write(padding, static_cast<std::streamsize>(Align8(bytes) - bytes));
+        }
+
+        template <typename T>
+        bool ReadArray(const char *&cursor, const char *end, std::uint64_t count, std::vector<T> &vec)
+        {
+            std::size_t bytes = static_cast<std::size_t>(count) * sizeof(T);
+            if (static_cast<std::size_t>(end - cursor) < Align8(bytes))
+                return false;
+            vec.resize(static_cast<std::size_t>(count));
+            if (bytes)
+                std::memcpy(vec.data(), cursor, bytes);
+            cursor += Align8(bytes);
+            return true;
+        }
+    } // namespace
+
+    TessellationCache &TessellationCache::GetInstance()
+    {
+        static TessellationCache instance;
+        return instance;
+    }
+
+    TessellationCache::TessellationCache()
+        : m_directory(std::filesystem::path(app::Application::GetUserCachePath()) / "Dev" / "Tessellation")
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(m_directory, ec);
+
+        std::uintmax_t size_mb = kDefaultCacheSizeMB;
+        auto grp = app::GetApplication().GetUserParameter().GetGroup("BaseApp/Preferences/Mod/Dev/Render");
+        if (grp)
+            size_mb = static_cast<std::uintmax_t>(grp->GetInt("DiskCacheSize", static_cast<int>(kDefaultCacheSizeMB)));
+        Trim(size_mb * 1024 * 1024);
+    }
+
+    bool TessellationCache::IsEnabled()
+    {
+        auto grp = app::GetApplication().GetUserParameter().GetGroup("BaseApp/Preferences/Mod/Dev/Render");
+        if (!grp)
+            return true;
+        return grp->GetBool("DiskCache", true);
+    }
+
+    const std::filesystem::path &TessellationCache::GetCacheDirectory() const
+    {
+        return m_directory;
+    }
+
+    std::filesystem::path TessellationCache::GetCacheFile(const std::string &key) const
+    {
+        return m_directory / (key + ".mesh");
+    }
+
+    FlatMeshInfo TessellationCache::GetOrBuild(const FlatMeshBuilder &builder,
+                                               const std::string &objId,
+                                               const AMCAX::TopoShape &shape,
+                                               bool isVertex,
+                                               bool isEdge,
+                                               bool isFace)
+    {
+        std::string key;
+        try
+        {
+            key = ComputeKey(shape, builder.GetParameters(), isVertex, isEdge, isFace);
+        }
+        catch (...)
+        {
+            return builder.Build(objId, shape, isVertex, isEdge, isFace);
+        }
+
+        if (auto cached = Load(key))
+        {
+            cached->id = objId;
+            return std::move(*cached);
+        }
+
+        auto mesh = builder.Build(objId, shape, isVertex, isEdge, isFace);
+        if (!mesh.IsEmpty())
+            Store(key, mesh);
+        return mesh;
+    }
+
+    std::string TessellationCache::ComputeKey(const AMCAX::TopoShape &shape,
+                                              const FlatMeshBuilder::Parameters &parameters,
+                                              bool isVertex,
+                                              bool isEdge,
+                                              bool isFace) const
+    {
+        std::ostringstream params;
+        params << kCacheVersion << ';' << parameters.linear_deflection << ';' << parameters.relative << ';'
+               << parameters.angular_deflection << ';' << parameters.isolated << ';'
+               << parameters.edge_deflection << ';' << parameters.edge_angular_deflection << ';'
+               << parameters.indexed_edges << ';' << isVertex << isEdge << isFace;
+        auto text = params.str();
+
+        const auto &tshape = shape.TShape();
+        if (tshape)
+        {
+            std::lock_guard<std::mutex> lock(m_memo_mutex);
+            auto range = m_memo.equal_range(tshape.get());
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                auto const &memo = it->second;
+                // 地址相同但原TShape已销毁时lock得到空指针，不会误用
+                if (memo.tshape.lock() == tshape && memo.location == shape.Location() &&
+                    memo.orientation == shape.Orientation() && memo.parameters == text)
+                    return memo.key;
+            }
+        }
+
+        HashStreamBuf buf;
+        {
+            // 不含三角网格的BRep只反映几何与位置，网格化前后结果一致
+            std::ostream os(&buf);
+            AMCAX::OCCTIO::OCCTTool::Write(shape, os, false);
+        }
+        buf.Update(text.data(), text.size());
+
+        char key[64];
+        std::snprintf(key, sizeof(key), "%016llx%016llx_%llx",
+                      static_cast<unsigned long long>(buf.h1),
+                      static_cast<unsigned long long>(buf.h2),
+                      static_cast<unsigned long long>(buf.length));
+
+        if (tshape)
+        {
+            std::lock_guard<std::mutex> lock(m_memo_mutex);
+            if (m_memo.size() >= kMemoPruneSize)
+            {
+                for (auto it = m_memo.begin(); it != m_memo.end();)
+                    it = it->second.tshape.expired() ? m_memo.erase(it) : std::next(it);
+            }
+            m_memo.emplace(tshape.get(), KeyMemo{tshape, shape.Location(), shape.Orientation(), std::move(text), key});
+        }
+        return key;
+    }
+
+    std::optional<FlatMeshInfo> TessellationCache::Load(const std::string &key) const
+    {
+        auto path = GetCacheFile(key);
+        std::error_code ec;
+        if (!std::filesystem::exists(path, ec))
+            return std::nullopt;
+
+        try
+        {
+#ifdef _WIN32
+            boost::interprocess::file_mapping mapping(path.wstring().c_str(), boost::interprocess::read_only);
+#else
+            boost::interprocess::file_mapping mapping(path.string().c_str(), boost::interprocess::read_only);
+#endif
+            boost::interprocess::mapped_region region(mapping, boost::interprocess::read_only);
+            const char *begin = static_cast<const char *>(region.get_address());
+            const char *end = begin + region.get_size();
+            if (region.get_size() < sizeof(FileHeader))
+                return std::nullopt;
+
+            FileHeader header;
+            std::memcpy(&header, begin, sizeof(FileHeader));
+            if (std::memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0 || header.version != kCacheVersion)
+                return std::nullopt;
+
+            FlatMeshInfo mesh;
+            mesh.category = header.category == 1 ? "POINT" : "SHAPE";
+            const char *cursor = begin + sizeof(FileHeader);
+            bool ok = ReadArray(cursor, end, header.sizes[POINTS], mesh.points) &&
+                      ReadArray(cursor, end, header.sizes[NORMALS], mesh.normals) &&
+                      ReadArray(cursor, end, header.sizes[FACETS], mesh.facets) &&
+                      ReadArray(cursor, end, header.sizes[FACE_POINT_OFFSETS], mesh.face_point_offsets) &&
+                      ReadArray(cursor, end, header.sizes[FACE_FACET_OFFSETS], mesh.face_facet_offsets) &&
+                      ReadArray(cursor, end, header.sizes[VERTICES], mesh.vertices) &&
+                      ReadArray(cursor, end, header.sizes[EDGE_POINTS], mesh.edge_points) &&
+                      ReadArray(cursor, end, header.sizes[EDGE_OFFSETS], mesh.edge_offsets) &&
+                      ReadArray(cursor, end, header.sizes[EDGE_INDICES], mesh.edge_indices) &&
+                      ReadArray(cursor, end, header.sizes[EDGE_INDEX_OFFSETS], mesh.edge_index_offsets);
+            if (!ok)
+                return std::nullopt;
+
+            // 更新使用时间，供Trim按最近使用保留
+            std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+            return mesh;
+        }
+        catch (...)
+        {
+            return std::nullopt;
+        }
+    }
+
+    bool TessellationCache::Store(const std::string &key, const FlatMeshInfo &mesh) const
+    {
+        auto path = GetCacheFile(key);
+        // 先写临时文件再改名，避免并发读取到不完整的文件
+        std::ostringstream suffix;
+        suffix << "." << std::this_thread::get_id() << ".tmp";
+        auto tmp_path = path;
+        tmp_path += suffix.str();
+
+        try
+        {
+            {
+                std::ofstream ofs(tmp_path, std::ios::binary | std::ios::trunc);
+                if (!ofs)
+                    return false;
+
+                FileHeader header{};
+                std::memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+                header.version = kCacheVersion;
+                header.category = mesh.category == "POINT" ? 1 : 0;
+                header.sizes[POINTS] = mesh.points.size();
+                header.sizes[NORMALS] = mesh.normals.size();
+                header.sizes[FACETS] = mesh.facets.size();
+                header.sizes[FACE_POINT_OFFSETS] = mesh.face_point_offsets.size();
+                header.sizes[FACE_FACET_OFFSETS] = mesh.face_facet_offsets.size();
+                header.sizes[VERTICES] = mesh.vertices.size();
+                header.sizes[EDGE_POINTS] = mesh.edge_points.size();
+                header.sizes[EDGE_OFFSETS] = mesh.edge_offsets.size();
+                header.sizes[EDGE_INDICES] = mesh.edge_indices.size();
+                header.sizes[EDGE_INDEX_OFFSETS] = mesh.edge_index_offsets.size();
+                ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+                WriteArray(ofs, mesh.points);
+                WriteArray(ofs, mesh.normals);
+                WriteArray(ofs, mesh.facets);
+                WriteArray(ofs, mesh.face_point_offsets);
+                WriteArray(ofs, mesh.face_facet_offsets);
+                WriteArray(ofs, mesh.vertices);
+                WriteArray(ofs, mesh.edge_points);
+                WriteArray(ofs, mesh.edge_offsets);
+                WriteArray(ofs, mesh.edge_indices);
+                WriteArray(ofs, mesh.edge_index_offsets);
+                if (!ofs)
+                    throw std::ios_base::failure("write tessellation cache failed");
+            }
+
+            std::error_code ec;
+            std::filesystem::rename(tmp_path, path, ec);
+            if (ec)
+            {
+                std::filesystem::remove(tmp_path, ec);
+                return false;
+            }
+            return true;
+        }
+        catch (...)
+        {
+            std::error_code ec;
+            std::filesystem::remove(tmp_path, ec);
+            LOGGING_ERROR("Store tessellation cache failed.");
+            return false;
+        }
+    }
+
+    void TessellationCache::Trim(std::uintmax_t max_bytes) const
+    {
+        struct Entry
+        {
+            std::filesystem::file_time_type time;
+            std::uintmax_t size;
+            std::filesystem::path path;
+        };
+
+        std::error_code ec;
+        std::vector<Entry> entries;
+        std::uintmax_t total = 0;
+        for (auto const &item : std::filesystem::directory_iterator(m_directory, ec))
+        {
+            if (!item.is_regular_file(ec))
+                continue;
+            // 上次异常退出遗留的临时文件
+            if (item.path().extension() == ".tmp")
+            {
+                std::filesystem::remove(item.path(), ec);
+                continue;
+            }
+            Entry entry{item.last_write_time(ec), item.file_size(ec), item.path()};
+            total += entry.size;
+            entries.push_back(std::move(entry));
+        }
+        if (total <= max_bytes)
+            return;
+
+        std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b)
+                  { return a.time < b.time; });
+        for (auto const &entry : entries)
+        {
+            if (total <= max_bytes)
+                break;
+            if (std::filesystem::remove(entry.path, ec))
+                total -= entry.size;
+        }
+    }
+
+} // namespace Dev
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <Base/Render/FlatMeshBuilder.h>
+#include <Base/Render/FlatMeshInfo.h>
+#include <topology/TopoLocation.hpp>
+#include <topology/TopoShape.hpp>
+
+namespace Dev {
+
+/**
+ * @brief 网格的磁盘缓存
+ *
+ * 缓存位于 Application::GetUserCachePath()/Dev/Tessellation 下，键由形状几何（不含三角网格的BRep）
+ * 与网格化参数共同计算，内容为FlatMeshInfo的二进制形式：定长文件头后依次存放各数组，
+ * 每段按8字节对齐，读取时通过文件映射直接拷贝，无需解析。
+ * 计算键需要把形状写成BRep文本，结果按TShape、位置、方向与参数记在内存中，
+ * 同一形状切换细节层次或重新生成网格时不再重复计算。
+ * 经过ViewProviderPart::UpdateData的形状更新（新建、重算、撤销重做）会使用缓存；
+ * 打开文档时恢复的形状在视图关联后由ViewProviderPart::UpdatePendingRender经过同一流程。
+ */
+class TessellationCache
+{
+  public:
+    // 第一次调用会读取用户参数并整理缓存目录，需在GUI线程进行
+    static TessellationCache& GetInstance();
+
+    // 用户参数 BaseApp/Preferences/Mod/Dev/Render 下的 DiskCache、DiskCacheSize（MB），只在GUI线程调用
+    static bool IsEnabled();
+
+    // 命中时读取缓存，否则生成网格并写入缓存；返回的网格id为objId
+    FlatMeshInfo GetOrBuild(const FlatMeshBuilder& builder,
+                            const std::string& objId,
+                            const AMCAX::TopoShape& shape,
+                            bool isVertex = true,
+                            bool isEdge = true,
+                            bool isFace = true);
+
+    // 可在任意线程调用
+    std::string ComputeKey(const AMCAX::TopoShape& shape,
+                           const FlatMeshBuilder::Parameters& parameters,
+                           bool isVertex,
+                           bool isEdge,
+                           bool isFace) const;
+
+    std::optional<FlatMeshInfo> Load(const std::string& key) const;
+    bool Store(const std::string& key, const FlatMeshInfo& mesh) const;
+
+    const std::filesystem::path& GetCacheDirectory() const;
+    // 按最后使用时间删除旧文件，使缓存总大小不超过max_bytes
+    void Trim(std::uintmax_t max_bytes) const;
+
+  private:
+    TessellationCache();
+
+    std::filesystem::path GetCacheFile(const std::string& key) const;
+
+    // 已计算过的键，TShape销毁后对应的记录失效
+    struct KeyMemo
+    {
+        std::weak_ptr<AMCAX::TopoTShape> tshape;
+        AMCAX::TopoLocation location;
+        AMCAX::OrientationType orientation;
+        std::string parameters;
+        std::string key;
+    };
+
+  private:
+    std::filesystem::path m_directory;
+    mutable std::mutex m_memo_mutex;
+    mutable std::unordered_multimap<const AMCAX::TopoTShape*, KeyMemo> m_memo;
+};
+
+}  // namespace Dev
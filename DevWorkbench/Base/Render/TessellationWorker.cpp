@@ -0,0 +1,117 @@
+#include "TessellationWorker.h"
+#include <App/Application.h>
+#include <Base/Parameter.h>
+#include <Logging/Logging.h>
+#include <QCoreApplication>
+#include <QMetaObject>
+#include <memory>
+#include <topology/TopoExplorer.hpp>
+
+namespace Dev
+{
+    namespace
+    {
+        constexpr int kDefaultMinFaces = 200;
+    } // namespace
+
+    TessellationWorker &TessellationWorker::GetInstance()
+    {
+        static TessellationWorker instance;
+        return instance;
+    }
+
+    TessellationWorker::~TessellationWorker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_latest.clear();
+        }
+        m_group.wait();
+    }
+
+    bool TessellationWorker::IsEnabled()
+    {
+        auto grp = app::GetApplication().GetUserParameter().GetGroup("BaseApp/Preferences/Mod/Dev/Render");
+        if (!grp)
+            return true;
+        return grp->GetBool("BackgroundMesh", true);
+    }
+
+    bool TessellationWorker::ShouldRunInBackground(const AMCAX::TopoShape &shape)
+    {
+        if (!IsEnabled() || shape.IsNull())
+            return false;
+
+        int min_faces = kDefaultMinFaces;
+        auto grp = app::GetApplication().GetUserParameter().GetGroup("BaseApp/Preferences/Mod/Dev/Render");
+        if (grp)
+            min_faces = static_cast<int>(grp->GetInt("BackgroundMeshMinFaces", kDefaultMinFaces));
+
+        // 达到阈值即停止计数
+        int count = 0;
+        for (AMCAX::TopoExplorer exp(shape, AMCAX::ShapeType::Face); exp.More() && count < min_faces; exp.Next())
+            ++count;
+        return count >= min_faces;
+    }
+
+    void TessellationWorker::Submit(const void *owner, Job job, Callback callback)
+    {
+        std::uint64_t generation;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            generation = ++m_generation;
+            m_latest[owner] = generation;
+        }
+
+        m_group.run([this, owner, generation, job = std::move(job), callback = std::move(callback)]()
+                    {
+            // 开始前已有更新的提交，直接跳过
+            if (!IsLatest(owner, generation))
+                return;
+
+            auto mesh = std::make_shared<FlatMeshInfo>();
+            try
+            {
+                *mesh = job();
+            }
+            catch (...)
+            {
+                LOGGING_ERROR("Background tessellation failed.");
+            }
+
+            QMetaObject::invokeMethod(
+                QCoreApplication::instance(),
+                [this, owner, generation, mesh, callback]()
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        auto it = m_latest.find(owner);
+                        if (it == m_latest.end() || it->second != generation)
+                            return;
+                        m_latest.erase(it);
+                    }
+                    callback(std::move(*mesh));
+                },
+                Qt::QueuedConnection); });
+    }
+
+    void TessellationWorker::Cancel(const void *owner)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_latest.erase(owner);
+    }
+
+    bool TessellationWorker::IsPending(const void *owner) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_latest.count(owner) > 0;
+    }
+
+    bool TessellationWorker::IsLatest(const void *owner, std::uint64_t generation) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_latest.find(owner);
+        return it != m_latest.end() && it->second == generation;
+    }
+
+} // namespace Dev
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <tbb/task_group.h>
+#include <Base/Render/FlatMeshInfo.h>
+#include <topology/TopoShape.hpp>
+
+namespace Dev {
+
+/**
+ * @brief 后台网格生成
+ *
+ * 网格在TBB线程池中生成，完成后回到GUI线程交给调用者。每个owner只保留最新一次提交：
+ * 新的提交使之前未开始的任务直接跳过，已完成但过期的结果被丢弃。
+ * owner销毁前需调用Cancel，之后不会再收到回调。
+ */
+class TessellationWorker
+{
+  public:
+    using Job = std::function<FlatMeshInfo()>;
+    using Callback = std::function<void(FlatMeshInfo&&)>;
+
+    static TessellationWorker& GetInstance();
+
+    // 用户参数 BaseApp/Preferences/Mod/Dev/Render/BackgroundMesh
+    static bool IsEnabled();
+    // 面数达到用户参数 BackgroundMeshMinFaces 的形状才放到后台，较小的形状同步生成更快且不闪烁
+    static bool ShouldRunInBackground(const AMCAX::TopoShape& shape);
+
+    // job在工作线程执行，callback在GUI线程执行
+    void Submit(const void* owner, Job job, Callback callback);
+    void Cancel(const void* owner);
+    bool IsPending(const void* owner) const;
+
+  private:
+    TessellationWorker() = default;
+    ~TessellationWorker();
+
+    bool IsLatest(const void* owner, std::uint64_t generation) const;
+
+  private:
+    mutable std::mutex m_mutex;
+    std::unordered_map<const void*, std::uint64_t> m_latest;
+    std::uint64_t m_generation = 0;
+    tbb::task_group m_group;
+};
+
+}  // namespace Dev
@@ -0,0 +1,48 @@
+#include "ShapeTransaction.h"
+#include <App/Application.h>
+#include <App/Document.h>
+#include <App/Properties/PropertyTopoShape.h>
+#include <Base/Parameter.h>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace Dev
+{
+    namespace
+    {
+        constexpr int kDefaultMemoryLimitMB = 512;
+        constexpr int kDefaultMaxSteps = 20;
+    } // namespace
+
+    void ShapeTransaction::ApplyUndoLimit(app::Document *doc)
+    {
+        if (!doc)
+            return;
+
+        std::uint64_t limit_mb = kDefaultMemoryLimitMB;
+        int max_steps = kDefaultMaxSteps;
+        auto grp = app::GetApplication().GetUserParameter().GetGroup("BaseApp/Preferences/Mod/Dev/Undo");
+        if (grp)
+        {
+            limit_mb = static_cast<std::uint64_t>(std::max<long>(0, grp->GetInt("MemoryLimit", kDefaultMemoryLimitMB)));
+            max_steps = static_cast<int>(grp->GetInt("MaxSteps", kDefaultMaxSteps));
+        }
+
+        // SetUndoLimit以字节为单位，超出32位时取最大值
+        std::uint64_t limit_bytes = std::min<std::uint64_t>(limit_mb * 1024 * 1024, std::numeric_limits<std::uint32_t>::max());
+        doc->SetUndoLimit(static_cast<std::uint32_t>(limit_bytes));
+        if (max_steps > 0)
+            doc->SetMaxUndoStackSize(static_cast<std::uint32_t>(max_steps));
+    }
+
+    bool ShapeTransaction::SetShape(app::PropertyTopoShape &prop, const AMCAX::TopoShape &shape)
+    {
+        auto const &current = prop.GetValue();
+        if (current.IsNull() ? shape.IsNull() : (!shape.IsNull() && current.IsEqual(shape)))
+            return false;
+        prop.SetValue(shape);
+        return true;
+    }
+
+} // namespace Dev
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <topology/TopoShape.hpp>
+
+namespace app {
+class Document;
+class PropertyTopoShape;
+}
+
+namespace Dev {
+
+/**
+ * @brief 形状属性修改与撤销内存的控制
+ *
+ * TopoShape本身是共享TShape的句柄，复制只增加引用计数；事务中保存的修改前形状与当前形状共享几何。
+ * 这里避免写入与当前值相同的形状（不产生新的事务记录），并按用户参数限制文档撤销栈占用的内存。
+ */
+class ShapeTransaction
+{
+  public:
+    // 用户参数 BaseApp/Preferences/Mod/Dev/Undo 下的 MemoryLimit（MB）、MaxSteps
+    static void ApplyUndoLimit(app::Document* doc);
+
+    // 形状与当前值相同（IsEqual）时不写入，返回是否写入
+    static bool SetShape(app::PropertyTopoShape& prop, const AMCAX::TopoShape& shape);
+};
+
+}  // namespace Dev
@@ -0,0 +1,136 @@
+#include "AttachmentStore.h"
+#include <App/Application.h>
+#include <Base/Parameter.h>
+#include <Base/XMLReader.h>
+#include <Base/XMLWriter.h>
+#include <Logging/Logging.h>
+#include <QByteArray>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <sstream>
+
+namespace Dev
+{
+    namespace
+    {
+        constexpr char kMagic[4] = {'D', 'V', 'A', 'T'};
+        constexpr std::uint32_t kFlagCompressed = 1;
+        constexpr std::size_t kHeaderSize = 8;
+
+        std::string ReadAll(std::istream &is)
+        {
+            return std::string((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+        }
+
+        void WriteHeader(std::ostream &os, std::uint32_t flags)
+        {
+            char header[kHeaderSize];
+            std::memcpy(header, kMagic, sizeof(kMagic));
+            for (int i = 0; i < 4; ++i)
+                header[4 + i] = static_cast<char>((flags >> (8 * i)) & 0xff);
+            os.write(header, kHeaderSize);
+        }
+
+        // 不压缩时直接写入存储器的输出流，压缩时先在内存中编码
+        bool Encode(std::ostream &os, const AttachmentStore::Encoder &encoder, bool compress)
+        {
+            try
+            {
+                if (!compress)
+                {
+                    WriteHeader(os, 0);
+                    return encoder(os) && os;
+                }
+
+                std::ostringstream oss(std::ios::binary);
+                if (!encoder(oss))
+                    return false;
+                std::string raw = std::move(oss).str();
+                QByteArray packed = qCompress(reinterpret_cast<const uchar *>(raw.data()), static_cast<qsizetype>(raw.size()));
+                WriteHeader(os, kFlagCompressed);
+                os.write(packed.constData(), static_cast<std::streamsize>(packed.size()));
+                return static_cast<bool>(os);
+            }
+            catch (...)
+            {
+                return false;
+            }
+        }
+
+        // 去掉文件头并按需解压，data原地替换为附件内容
+        bool Unpack(std::string &data)
+        {
+            bool has_header = data.size() >= kHeaderSize && std::memcmp(data.data(), kMagic, sizeof(kMagic)) == 0;
+            // 旧附件没有文件头，整体交给decoder
+            if (!has_header)
+                return true;
+
+            std::uint32_t flags = 0;
+            for (int i = 0; i < 4; ++i)
+                flags |= static_cast<std::uint32_t>(static_cast<unsigned char>(data[4 + i])) << (8 * i);
+            if (flags & kFlagCompressed)
+            {
+                QByteArray raw = qUncompress(reinterpret_cast<const uchar *>(data.data() + kHeaderSize), static_cast<qsizetype>(data.size() - kHeaderSize));
+                if (raw.isEmpty() && data.size() > kHeaderSize)
+                    return false;
+                data.assign(raw.constData(), static_cast<std::size_t>(raw.size()));
+            }
+            else
+            {
+                data.erase(0, kHeaderSize);
+            }
+            return true;
+        }
+
+        bool Decode(std::istream &is, const AttachmentStore::Decoder &decoder)
+        {
+            try
+            {
+                std::string data = ReadAll(is);
+                if (!Unpack(data))
+                    return false;
+                std::istringstream iss(std::move(data), std::ios::binary);
+                return decoder(iss);
+            }
+            catch (...)
+            {
+                return false;
+            }
+        }
+    } // namespace
+
+    bool AttachmentStore::IsCompressionEnabled()
+    {
+        auto grp = app::GetApplication().GetUserParameter().GetGroup("BaseApp/Preferences/Mod/Dev/Document");
+        if (!grp)
+            return false;
+        return grp->GetBool("CompressAttachments", false);
+    }
+
+    void AttachmentStore::Write(base::XMLWriter &writer,
+                                std::string_view name,
+                                std::string_view filename,
+                                const base::Persistence *owner,
+                                Encoder encoder)
+    {
+        bool compress = IsCompressionEnabled();
+        writer.WriteAttachment(name, filename, owner, [encoder = std::move(encoder), compress](std::ostream &os, std::uint32_t)
+                               {
+                                   bool ok = Encode(os, encoder, compress);
+                                   if (!ok)
+                                       LOGGING_ERROR("Write attachment failed.");
+                                   return ok; });
+    }
+
+    void AttachmentStore::Read(base::XMLReader &reader, const std::string &name, Decoder decoder)
+    {
+        reader.ReadAttachment(name, [decoder = std::move(decoder)](std::istream &is, std::uint32_t)
+                              {
+                                  bool ok = Decode(is, decoder);
+                                  if (!ok)
+                                      LOGGING_ERROR("Read attachment failed.");
+                                  return ok; });
+    }
+
+} // namespace Dev
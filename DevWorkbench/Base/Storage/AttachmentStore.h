@@ -0,0 +1,44 @@
+#pragma once
+
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace base {
+class Persistence;
+class XMLReader;
+class XMLWriter;
+}
+
+namespace Dev {
+
+/**
+ * @brief 插件附件的写入与读取
+ *
+ * 通过base::XMLWriter::WriteAttachment登记，存储器Finalize时按登记顺序在GUI线程编码写出。
+ * 只作用于插件自己写出的附件（如DevSetup的排序表），部件形状由SDK的属性写出，不经过这里。
+ * 附件以8字节头开始（标识与压缩标志），可选用qCompress压缩；读取时同时兼容没有文件头的旧附件。
+ * 读取同样在Finalize中按顺序进行，部件形状由SDK的PropertyTopoShape::Restore读取，无法并行或延迟解码。
+ */
+class AttachmentStore
+{
+  public:
+    using Encoder = std::function<bool(std::ostream&)>;
+    using Decoder = std::function<bool(std::istream&)>;
+
+    // 用户参数 BaseApp/Preferences/Mod/Dev/Document/CompressAttachments
+    static bool IsCompressionEnabled();
+
+    // encoder在Finalize时执行，只能访问调用时已复制的数据
+    static void Write(base::XMLWriter& writer,
+                      std::string_view name,
+                      std::string_view filename,
+                      const base::Persistence* owner,
+                      Encoder encoder);
+
+    static void Read(base::XMLReader& reader, const std::string& name, Decoder decoder);
+};
+
+}  // namespace Dev
@@ -0,0 +1,166 @@
+#include "CompressedShape.h"
+#include <QByteArray>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iterator>
+#include <occtio/OCCTTool.hpp>
+#include <sstream>
+#include <string>
+
+namespace Dev
+{
+    namespace
+    {
+        constexpr char kMagic[4] = {'D', 'B', 'R', 'P'};
+        constexpr std::uint32_t kFlagCompressed = 1;
+        // 标识、版本、标志位各4字节，原始长度、正文长度各8字节
+        constexpr std::size_t kHeaderSize = 4 + 4 + 4 + 8 + 8;
+
+        template <typename T>
+        void PutLE(char *dst, T value)
+        {
+            for (std::size_t i = 0; i < sizeof(T); ++i)
+                dst[i] = static_cast<char>((static_cast<std::uint64_t>(value) >> (8 * i)) & 0xff);
+        }
+
+        template <typename T>
+        T GetLE(const char *src)
+        {
+            std::uint64_t value = 0;
+            for (std::size_t i = 0; i < sizeof(T); ++i)
+                value |= static_cast<std::uint64_t>(static_cast<unsigned char>(src[i])) << (8 * i);
+            return static_cast<T>(value);
+        }
+
+        // 输入流剩余的字节数，不能定位的流返回-1
+        std::streamoff RemainingBytes(std::istream &is)
+        {
+            auto pos = is.tellg();
+            if (pos == std::streampos(-1))
+                return -1;
+            is.seekg(0, std::ios::end);
+            auto end = is.tellg();
+            is.seekg(pos);
+            if (end == std::streampos(-1) || !is)
+            {
+                is.clear();
+                return -1;
+            }
+            return end - pos;
+        }
+
+        // 按块读取，不能定位的流也不会按文件头中的长度一次分配
+        bool ReadBody(std::istream &is, std::uint64_t size, std::string &body)
+        {
+            constexpr std::size_t kChunkSize = 1u << 20;
+            body.clear();
+            while (body.size() < size)
+            {
+                std::size_t chunk = static_cast<std::size_t>(std::min<std::uint64_t>(kChunkSize, size - body.size()));
+                std::size_t offset = body.size();
+                body.resize(offset + chunk);
+                is.read(body.data() + offset, static_cast<std::streamsize>(chunk));
+                if (static_cast<std::size_t>(is.gcount()) != chunk)
+                    return false;
+            }
+            return true;
+        }
+    } // namespace
+
+    bool CompressedShape::Write(const AMCAX::TopoShape &shape, std::ostream &os, bool compress)
+    {
+        std::ostringstream oss(std::ios::binary);
+        if (!AMCAX::OCCTIO::OCCTTool::Write(shape, oss, false))
+            return false;
+        std::string raw = std::move(oss).str();
+
+        std::uint32_t flags = 0;
+        QByteArray packed;
+        const char *body = raw.data();
+        std::uint64_t body_size = raw.size();
+        if (compress)
+        {
+            packed = qCompress(reinterpret_cast<const uchar *>(raw.data()), static_cast<qsizetype>(raw.size()));
+            body = packed.constData();
+            body_size = static_cast<std::uint64_t>(packed.size());
+            flags |= kFlagCompressed;
+        }
+
+        std::array<char, kHeaderSize> header{};
+        std::memcpy(header.data(), kMagic, sizeof(kMagic));
+        PutLE<std::uint32_t>(header.data() + 4, kVersion);
+        PutLE<std::uint32_t>(header.data() + 8, flags);
+        PutLE<std::uint64_t>(header.data() + 12, raw.size());
+        PutLE<std::uint64_t>(header.data() + 20, body_size);
+        os.write(header.data(), static_cast<std::streamsize>(header.size()));
+        os.write(body, static_cast<std::streamsize>(body_size));
+        return static_cast<bool>(os);
+    }
+
+    bool CompressedShape::Read(AMCAX::TopoShape &shape, std::istream &is)
+    {
+        std::array<char, kHeaderSize> header{};
+        is.read(header.data(), sizeof(kMagic));
+        if (is.gcount() != sizeof(kMagic) || std::memcmp(header.data(), kMagic, sizeof(kMagic)) != 0)
+        {
+            // 文本BRep，把已读取的字节放回去
+            is.clear();
+            std::string text(header.data(), static_cast<std::size_t>(is.gcount()));
+            text.append(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+            std::istringstream iss(std::move(text));
+            return AMCAX::OCCTIO::OCCTTool::Read(shape, iss);
+        }
+
+        is.read(header.data() + sizeof(kMagic), static_cast<std::streamsize>(kHeaderSize - sizeof(kMagic)));
+        if (static_cast<std::size_t>(is.gcount()) != kHeaderSize - sizeof(kMagic))
+            return false;
+        auto version = GetLE<std::uint32_t>(header.data() + 4);
+        auto flags = GetLE<std::uint32_t>(header.data() + 8);
+        auto raw_size = GetLE<std::uint64_t>(header.data() + 12);
+        auto body_size = GetLE<std::uint64_t>(header.data() + 20);
+        if (version > kVersion)
+            return false;
+
+        auto remaining = RemainingBytes(is);
+        if (remaining >= 0 && body_size > static_cast<std::uint64_t>(remaining))
+            return false;
+
+        std::string body;
+        if (remaining >= 0)
+        {
+            body.resize(static_cast<std::size_t>(body_size));
+            is.read(body.data(), static_cast<std::streamsize>(body_size));
+            if (static_cast<std::uint64_t>(is.gcount()) != body_size)
+                return false;
+        }
+        else if (!ReadBody(is, body_size, body))
+        {
+            return false;
+        }
+
+        if (flags & kFlagCompressed)
+        {
+            // qCompress的前4字节是大端序的原始长度，与文件头不符时不解压
+            if (body.size() < 4)
+                return false;
+            std::uint64_t packed_size = 0;
+            for (int i = 0; i < 4; ++i)
+                packed_size = (packed_size << 8) | static_cast<unsigned char>(body[i]);
+            if (packed_size != raw_size)
+                return false;
+            QByteArray raw = qUncompress(reinterpret_cast<const uchar *>(body.data()), static_cast<qsizetype>(body.size()));
+            if (static_cast<std::uint64_t>(raw.size()) != raw_size)
+                return false;
+            body.assign(raw.constData(), static_cast<std::size_t>(raw.size()));
+        }
+        else if (body.size() != raw_size)
+        {
+            return false;
+        }
+
+        std::istringstream iss(std::move(body), std::ios::binary);
+        return AMCAX::OCCTIO::OCCTTool::Read(shape, iss);
+    }
+
+} // namespace Dev
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <topology/TopoShape.hpp>
+
+namespace Dev {
+
+/**
+ * @brief RecoveryJournal内部使用的带版本压缩BRep形状记录
+ *
+ * 文件头为小端序的定长字段：标识"DBRP"、版本号、标志位、正文原始长度、正文长度，其后为正文。
+ * 正文是AMCAX的文本BRep（不含三角网格），共享的TShape与几何在BRep的表中只出现一次；按标志位用qCompress压缩。
+ * 读取时先按输入流剩余长度检查文件头中的长度，再分配内存。
+ * Read同时兼容没有文件头的文本BRep。
+ * 正文仍是文本BRep，读写都比直接读写.brep多一次压缩或解压，只用于减小恢复日志的体积，不作为导入导出格式。
+ */
+class CompressedShape
+{
+  public:
+    static constexpr std::uint32_t kVersion = 1;
+
+    static bool Write(const AMCAX::TopoShape& shape, std::ostream& os, bool compress = true);
+    static bool Read(AMCAX::TopoShape& shape, std::istream& is);
+};
+
+}  // namespace Dev
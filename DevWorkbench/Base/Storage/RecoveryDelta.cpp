@@ -0,0 +1,161 @@
+#include "RecoveryDelta.h"
+#include <array>
+#include <cstring>
+
+namespace Dev
+{
+    namespace
+    {
+        constexpr char kMagic[4] = {'D', 'V', 'R', 'J'};
+        constexpr std::uint32_t kVersion = 2;
+
+        template <typename T>
+        void WriteLE(std::ostream &os, T value)
+        {
+            std::array<char, sizeof(T)> bytes{};
+            for (std::size_t i = 0; i < sizeof(T); ++i)
+                bytes[i] = static_cast<char>((static_cast<std::uint64_t>(value) >> (8 * i)) & 0xff);
+            os.write(bytes.data(), bytes.size());
+        }
+
+        // 按文件剩余长度检查读取的数据，长度字段不可信，超出剩余长度时不分配
+        struct DeltaReader
+        {
+            std::istream &is;
+            std::uint64_t remaining = 0;
+
+            bool Read(char *data, std::uint64_t size)
+            {
+                if (size > remaining || !is.read(data, static_cast<std::streamsize>(size)))
+                    return false;
+                remaining -= size;
+                return true;
+            }
+
+            // 至少还有count个、每个min_size字节的元素
+            bool HasRoom(std::uint64_t count, std::uint64_t min_size) const
+            {
+                return count <= remaining / min_size;
+            }
+        };
+
+        template <typename T>
+        bool ReadLE(DeltaReader &reader, T &value)
+        {
+            std::array<char, sizeof(T)> bytes{};
+            if (!reader.Read(bytes.data(), bytes.size()))
+                return false;
+            std::uint64_t result = 0;
+            for (std::size_t i = 0; i < sizeof(T); ++i)
+                result |= static_cast<std::uint64_t>(static_cast<unsigned char>(bytes[i])) << (8 * i);
+            value = static_cast<T>(result);
+            return true;
+        }
+
+        void WriteString(std::ostream &os, const std::string &str)
+        {
+            WriteLE<std::uint64_t>(os, str.size());
+            os.write(str.data(), static_cast<std::streamsize>(str.size()));
+        }
+
+        bool ReadString(DeltaReader &reader, std::string &str)
+        {
+            std::uint64_t size = 0;
+            if (!ReadLE(reader, size) || size > reader.remaining)
+                return false;
+            str.resize(static_cast<std::size_t>(size));
+            return reader.Read(str.data(), size);
+        }
+    } // namespace
+
+    bool RecoveryDelta::Write(std::ostream &os, const std::vector<Record> &records)
+    {
+        os.write(kMagic, sizeof(kMagic));
+        WriteLE<std::uint32_t>(os, kVersion);
+        WriteLE<std::uint32_t>(os, static_cast<std::uint32_t>(records.size()));
+        for (auto const &record : records)
+        {
+            WriteLE<std::uint8_t>(os, static_cast<std::uint8_t>(record.op));
+            WriteString(os, record.name);
+            if (record.op != Operation::Update)
+                continue;
+            WriteString(os, record.label);
+            WriteLE<std::uint32_t>(os, static_cast<std::uint32_t>(record.face_colors.size()));
+            for (auto const &[face, packed] : record.face_colors)
+            {
+                WriteLE<std::uint32_t>(os, static_cast<std::uint32_t>(face));
+                WriteLE<std::uint32_t>(os, packed);
+            }
+            WriteLE<std::uint32_t>(os, static_cast<std::uint32_t>(record.face_names.size()));
+            for (auto const &[sub_name, name] : record.face_names)
+            {
+                WriteString(os, sub_name);
+                WriteString(os, name);
+            }
+            WriteLE<std::uint32_t>(os, record.solid_color);
+            WriteString(os, record.shape);
+        }
+        return static_cast<bool>(os);
+    }
+
+    bool RecoveryDelta::Read(std::istream &is, std::uint64_t size, std::vector<Record> &records)
+    {
+        DeltaReader reader{is, size};
+
+        char magic[sizeof(kMagic)];
+        if (!reader.Read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0)
+            return false;
+        std::uint32_t version = 0, count = 0;
+        // 增量只在两次保存之间存在，不读取其他版本
+        if (!ReadLE(reader, version) || version != kVersion || !ReadLE(reader, count))
+            return false;
+        // 每条记录至少有操作类型与名称长度
+        if (!reader.HasRoom(count, 1 + 8))
+            return false;
+
+        records.clear();
+        records.reserve(count);
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            Record record;
+            std::uint8_t op = 0;
+            if (!ReadLE(reader, op) || !ReadString(reader, record.name))
+                return false;
+            record.op = static_cast<Operation>(op);
+            if (record.op == Operation::Update)
+            {
+                std::uint32_t color_count = 0;
+                if (!ReadString(reader, record.label) || !ReadLE(reader, color_count) || !reader.HasRoom(color_count, 8))
+                    return false;
+                record.face_colors.reserve(color_count);
+                for (std::uint32_t k = 0; k < color_count; ++k)
+                {
+                    std::uint32_t face = 0, packed = 0;
+                    if (!ReadLE(reader, face) || !ReadLE(reader, packed))
+                        return false;
+                    record.face_colors.emplace_back(static_cast<int>(face), packed);
+                }
+                std::uint32_t name_count = 0;
+                if (!ReadLE(reader, name_count) || !reader.HasRoom(name_count, 8 + 8))
+                    return false;
+                record.face_names.reserve(name_count);
+                for (std::uint32_t k = 0; k < name_count; ++k)
+                {
+                    std::string sub_name, name;
+                    if (!ReadString(reader, sub_name) || !ReadString(reader, name))
+                        return false;
+                    record.face_names.emplace_back(std::move(sub_name), std::move(name));
+                }
+                if (!ReadLE(reader, record.solid_color) || !ReadString(reader, record.shape))
+                    return false;
+            }
+            else if (record.op != Operation::Remove)
+            {
+                return false;
+            }
+            records.push_back(std::move(record));
+        }
+        return true;
+    }
+
+} // namespace Dev
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Dev {
+
+/**
+ * @brief 恢复日志增量文件的编码
+ *
+ * 小端序：标识"DVRJ"、版本号、记录数，其后逐条为操作类型、名称，更新记录再依次为标签、面颜色、面名称、实体颜色与形状。
+ * 只依赖标准库，读取时所有长度、数量都先与剩余字节数比较再分配。
+ */
+class RecoveryDelta
+{
+  public:
+    enum class Operation : std::uint8_t
+    {
+        Update = 1,
+        Remove = 2,
+    };
+
+    struct Record
+    {
+        Operation op = Operation::Update;
+        std::string name;
+        std::string label;
+        std::uint32_t solid_color = 0;
+        std::vector<std::pair<int, std::uint32_t>> face_colors;
+        std::vector<std::pair<std::string, std::string>> face_names;
+        // CompressedShape编码后的形状
+        std::string shape;
+    };
+
+    static bool Write(std::ostream& os, const std::vector<Record>& records);
+    // size为输入中增量的字节数，数据不完整或不一致时返回false
+    static bool Read(std::istream& is, std::uint64_t size, std::vector<Record>& records);
+};
+
+}  // namespace Dev
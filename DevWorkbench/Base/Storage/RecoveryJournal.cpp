@@ -0,0 +1,509 @@
+#include "RecoveryJournal.h"
+#include "CompressedShape.h"
+#include "RecoveryDelta.h"
+#include <App/Application.h>
+#include <App/Color.h>
+#include <App/Document.h>
+#include <App/DocumentObjectTopoShape.h>
+#include <Base/AutoSaveControl.h>
+#include <Base/DevSetup.h>
+#include <Base/Import/ImportGuard.h>
+#include <Base/Parameter.h>
+#include <Base/PartCollection.h>
+#include <Base/ShapeTransaction.h>
+#include <Gui/MainWindow.h>
+#include <Logging/Logging.h>
+#include <QCryptographicHash>
+#include <QMessageBox>
+#include <QStandardPaths>
+#include <QString>
+#include <QTimer>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <tbb/parallel_for.h>
+
+namespace Dev
+{
+    namespace
+    {
+        constexpr int kDefaultIntervalMinutes = 5;
+        constexpr char kDeltaPrefix[] = "delta_";
+        constexpr char kDeltaSuffix[] = ".dvj";
+
+        // GUI线程中的快照，形状与颜色表只复制句柄
+        struct Snapshot
+        {
+            RecoveryJournal::Operation op = RecoveryJournal::Operation::Update;
+            std::string name;
+            std::string label;
+            std::uint32_t solid_color = 0;
+            std::vector<std::pair<int, std::uint32_t>> face_colors;
+            std::vector<std::pair<std::string, std::string>> face_names;
+            AMCAX::TopoShape shape;
+        };
+
+        std::filesystem::path DeltaPath(const std::filesystem::path &dir, std::uint32_t sequence)
+        {
+            char name[32];
+            std::snprintf(name, sizeof(name), "%s%08u%s", kDeltaPrefix, sequence, kDeltaSuffix);
+            return dir / name;
+        }
+
+        int GetIntervalMinutes()
+        {
+            auto grp = app::GetApplication().GetUserParameter().GetGroup("BaseApp/Preferences/Mod/Dev/Document");
+            if (!grp)
+                return kDefaultIntervalMinutes;
+            return static_cast<int>(grp->GetInt("IncrementalAutoSaveInterval", kDefaultIntervalMinutes));
+        }
+    } // namespace
+
+    RecoveryJournal &RecoveryJournal::GetInstance()
+    {
+        static RecoveryJournal instance;
+        return instance;
+    }
+
+    RecoveryJournal::~RecoveryJournal()
+    {
+        m_group.wait();
+    }
+
+    bool RecoveryJournal::IsEnabled()
+    {
+        auto grp = app::GetApplication().GetUserParameter().GetGroup("BaseApp/Preferences/Mod/Dev/Document");
+        if (!grp)
+            return true;
+        return grp->GetBool("IncrementalAutoSave", true);
+    }
+
+    void RecoveryJournal::Attach(app::Document *doc, PartCollection *parts)
+    {
+        if (!doc || !parts || !IsEnabled())
+            return;
+        auto &journal = m_journals[doc];
+        if (journal && journal->parts == parts)
+            return;
+
+        journal = std::make_unique<Journal>();
+        journal->document = doc;
+        journal->parts = parts;
+        auto *j = journal.get();
+        auto touch = [this, j](const app::DocumentObject &obj)
+        { Touch(*j, obj); };
+        auto touch_all = [this, j](const std::vector<const app::DocumentObject *> &objects)
+        {
+            for (auto obj : objects)
+                Touch(*j, *obj);
+        };
+        journal->connections.emplace_back(parts->SignalNewObject.connect(touch));
+        journal->connections.emplace_back(parts->SignalNewObjects.connect(touch_all));
+        journal->connections.emplace_back(parts->SignalObjectPropertyChanged.connect([touch](const app::DocumentObject &obj, const app::Property &)
+                                                                                      { touch(obj); }));
+        journal->connections.emplace_back(parts->SignalObjectsChanged.connect(touch_all));
+        journal->connections.emplace_back(parts->SignalDeletedObject.connect([this, j](const app::DocumentObject &obj)
+                                                                              {
+                                                                                  if (!IsJournaled(obj))
+                                                                                  {
+                                                                                      Touch(*j, obj);
+                                                                                      return;
+                                                                                  }
+                                                                                  std::string name(obj.GetNameInDocument());
+                                                                                  j->touched.erase(name);
+                                                                                  j->removed.insert(std::move(name)); }));
+        // 保存后文件中已包含所有修改
+        journal->connections.emplace_back(doc->SignalFinishStoreToFile.connect([this, doc](const app::Document &, std::filesystem::path const &)
+                                                                                { Discard(doc); }));
+        // 新建的文档在关联日志之前只能由主程序的自动保存负责
+        if (!m_new_document.connected())
+            m_new_document = app::GetApplication().SignalNewDocument.connect([this](const app::Document &, bool)
+                                                                             { UpdateAutoSave(); });
+        EnsureTimer();
+        UpdateAutoSave();
+    }
+
+    void RecoveryJournal::Detach(const app::Document *doc)
+    {
+        auto it = m_journals.find(doc);
+        if (it == m_journals.end())
+            return;
+        m_group.wait();
+        std::error_code ec;
+        std::filesystem::remove_all(GetDirectory(doc), ec);
+        m_journals.erase(it);
+        UpdateAutoSave(doc);
+    }
+
+    bool RecoveryJournal::IsJournaled(const app::DocumentObject &obj)
+    {
+        return obj.GetClassTypePolymorphic() == app::DocumentObjectTopoShape::GetClassType();
+    }
+
+    void RecoveryJournal::Touch(Journal &journal, const app::DocumentObject &obj)
+    {
+        if (!IsJournaled(obj))
+        {
+            if (!journal.uncovered)
+            {
+                journal.uncovered = true;
+                UpdateAutoSave();
+            }
+            return;
+        }
+        std::string name(obj.GetNameInDocument());
+        journal.removed.erase(name);
+        journal.touched.insert(std::move(name));
+    }
+
+    void RecoveryJournal::EnsureTimer()
+    {
+        if (m_timer)
+            return;
+        int minutes = GetIntervalMinutes();
+        if (minutes <= 0)
+            return;
+        // 以主窗口为父对象，随主窗口一起释放
+        m_timer = new QTimer(gui::GetMainWindow());
+        m_timer->setInterval(minutes * 60 * 1000);
+        QObject::connect(m_timer, &QTimer::timeout, [this]()
+                         { OnTimer(); });
+        QObject::connect(m_timer, &QObject::destroyed, [this]()
+                         { m_timer = nullptr; });
+        m_timer->start();
+    }
+
+    void RecoveryJournal::OnTimer()
+    {
+        // 导入事务中途的部件不完整，修改记录保留到下一次
+        if (ImportGuard::IsActive())
+            return;
+        for (auto &[doc, journal] : m_journals)
+            Flush(journal->document);
+    }
+
+    void RecoveryJournal::Flush(app::Document *doc)
+    {
+        auto it = m_journals.find(doc);
+        if (it == m_journals.end())
+            return;
+        auto &journal = *it->second;
+        if (journal.touched.empty() && journal.removed.empty())
+            return;
+        // 从未保存的文档没有可以合并的基础文件，由主程序的自动保存负责
+        if (doc->GetFileName().empty())
+            return;
+
+        auto dir = GetDirectory(doc);
+        if (dir.empty())
+            return;
+
+        std::vector<Snapshot> snapshots;
+        snapshots.reserve(journal.touched.size() + journal.removed.size());
+        for (auto const &name : journal.touched)
+        {
+            auto part = journal.parts->FindObject(name);
+            if (!part || !IsJournaled(*part))
+                continue;
+            Snapshot snapshot;
+            snapshot.name = name;
+            snapshot.label = std::string(part->Label.GetValue());
+            snapshot.shape = part->Shape.GetValue();
+            snapshot.solid_color = part->SolidColor.GetValue().GetPackedValue();
+            for (auto const &[face, color] : part->FaceColors.GetValues())
+                snapshot.face_colors.emplace_back(face, color.GetPackedValue());
+            snapshot.face_names.assign(part->FaceNames.GetValues().begin(), part->FaceNames.GetValues().end());
+            snapshots.push_back(std::move(snapshot));
+        }
+        for (auto const &name : journal.removed)
+        {
+            Snapshot snapshot;
+            snapshot.op = Operation::Remove;
+            snapshot.name = name;
+            snapshots.push_back(std::move(snapshot));
+        }
+        journal.touched.clear();
+        journal.removed.clear();
+
+        if (journal.sequence == 0)
+        {
+            auto deltas = ListDeltas(dir);
+            journal.sequence = deltas.empty() ? 0 : deltas.rbegin()->first;
+        }
+        auto sequence = ++journal.sequence;
+
+        m_group.run([dir, sequence, snapshots = std::move(snapshots)]()
+                    {
+                        std::vector<Record> records(snapshots.size());
+                        tbb::parallel_for(std::size_t(0), snapshots.size(), [&](std::size_t i)
+                                          {
+                                              auto const &snapshot = snapshots[i];
+                                              auto &record = records[i];
+                                              record.op = snapshot.op;
+                                              record.name = snapshot.name;
+                                              record.label = snapshot.label;
+                                              record.solid_color = snapshot.solid_color;
+                                              record.face_colors = snapshot.face_colors;
+                                              record.face_names = snapshot.face_names;
+                                              if (snapshot.op == Operation::Update && !snapshot.shape.IsNull())
+                                              {
+                                                  std::ostringstream oss(std::ios::binary);
+                                                  if (CompressedShape::Write(snapshot.shape, oss))
+                                                      record.shape = std::move(oss).str();
+                                              } });
+
+                        std::error_code ec;
+                        std::filesystem::create_directories(dir, ec);
+                        auto target = DeltaPath(dir, sequence);
+                        auto temp = target;
+                        temp += ".tmp";
+                        if (!WriteDelta(temp, records))
+                        {
+                            std::filesystem::remove(temp, ec);
+                            LOGGING_ERROR("Write recovery journal failed.");
+                            return;
+                        }
+                        std::filesystem::rename(temp, target, ec);
+                        if (ec)
+                            LOGGING_ERROR("Commit recovery journal failed."); });
+    }
+
+    void RecoveryJournal::Discard(app::Document *doc)
+    {
+        auto it = m_journals.find(doc);
+        if (it == m_journals.end())
+            return;
+        m_group.wait();
+        std::error_code ec;
+        std::filesystem::remove_all(GetDirectory(doc), ec);
+        it->second->touched.clear();
+        it->second->removed.clear();
+        it->second->sequence = 0;
+        it->second->uncovered = false;
+        // 另存为后从未保存的文档也有了文件名
+        UpdateAutoSave();
+    }
+
+    void RecoveryJournal::UpdateAutoSave(const app::Document *closing) const
+    {
+        // 日志不定时写出时无法代替自动保存
+        bool covered = m_timer != nullptr;
+        for (auto doc : app::GetApplication().GetDocuments())
+        {
+            if (!covered)
+                break;
+            if (doc == closing)
+                continue;
+            auto it = m_journals.find(doc);
+            covered = it != m_journals.end() && !it->second->uncovered && !doc->GetFileName().empty();
+        }
+        AutoSaveControl::SetCoveredByJournal(covered);
+    }
+
+    bool RecoveryJournal::HasRecovery(const app::Document *doc) const
+    {
+        return doc && !doc->GetFileName().empty() && !ListDeltas(GetDirectory(doc)).empty();
+    }
+
+    std::size_t RecoveryJournal::Recover(app::Document *doc)
+    {
+        auto it = m_journals.find(doc);
+        if (it == m_journals.end())
+            return 0;
+        auto parts = it->second->parts;
+        auto dir = GetDirectory(doc);
+
+        // 按序号合并，同一部件只保留最后一条记录
+        std::vector<Record> records;
+        std::unordered_map<std::string, std::size_t> latest;
+        for (auto const &[sequence, file] : ListDeltas(dir))
+        {
+            // 损坏的增量只跳过自身，不影响其他增量
+            std::vector<Record> delta;
+            bool ok = false;
+            try
+            {
+                ok = ReadDelta(file, delta);
+            }
+            catch (...)
+            {
+                ok = false;
+            }
+            if (!ok)
+            {
+                LOGGING_ERROR("Read recovery journal failed.");
+                continue;
+            }
+            for (auto &record : delta)
+            {
+                auto [pos, inserted] = latest.emplace(record.name, records.size());
+                if (inserted)
+                    records.push_back(std::move(record));
+                else
+                    records[pos->second] = std::move(record);
+            }
+        }
+        if (records.empty())
+            return 0;
+
+        // 形状解码与文档无关，先并行完成
+        std::vector<std::optional<AMCAX::TopoShape>> shapes(records.size());
+        tbb::parallel_for(std::size_t(0), records.size(), [&](std::size_t i)
+                          {
+                              if (records[i].shape.empty())
+                                  return;
+                              try
+                              {
+                                  AMCAX::TopoShape shape;
+                                  std::istringstream iss(records[i].shape, std::ios::binary);
+                                  if (CompressedShape::Read(shape, iss))
+                                      shapes[i] = std::move(shape);
+                              }
+                              catch (...)
+                              {
+                                  LOGGING_ERROR("Decode recovery shape failed.");
+                              } });
+
+        app::OpenCommand("Recover");
+        {
+            PartCollection::ScopedBatch batch(parts);
+            for (std::size_t i = 0; i < records.size(); ++i)
+            {
+                auto const &record = records[i];
+                auto part = parts->FindObject(record.name);
+                // 同名对象已是特征时不覆盖
+                if (part && !IsJournaled(*part))
+                    continue;
+                if (record.op == Operation::Remove)
+                {
+                    if (part)
+                        parts->RemovePart(part);
+                    continue;
+                }
+                // 上次保存后新建的部件按标签重新创建，文档内名称可能不同，排在树的末尾
+                if (!part)
+                    part = parts->GetSetup()->AddPart(record.label);
+                part->Label.SetValue(record.label);
+                // 位置保存在形状中，随形状一起恢复
+                if (shapes[i])
+                    ShapeTransaction::SetShape(part->Shape, *shapes[i]);
+                part->SolidColor.SetValue(record.solid_color);
+                std::unordered_map<int, app::Color> colors;
+                for (auto const &[face, packed] : record.face_colors)
+                    colors.emplace(face, app::Color(packed));
+                part->FaceColors.SetValue(colors);
+                part->FaceNames.SetValues(std::map<std::string, std::string>(record.face_names.begin(), record.face_names.end()));
+            }
+        }
+        app::CommitCommand();
+
+        // 恢复的修改会重新记录，旧增量不再需要
+        for (auto const &[sequence, file] : ListDeltas(dir))
+        {
+            std::error_code ec;
+            std::filesystem::remove(file, ec);
+        }
+        it->second->sequence = 0;
+        return records.size();
+    }
+
+    void RecoveryJournal::OfferRecovery(app::Document *doc)
+    {
+        if (!HasRecovery(doc))
+            return;
+        auto answer = QMessageBox::question(gui::GetMainWindow(), QObject::tr("恢复"), QObject::tr("检测到该文档上次未保存的部件修改，是否恢复？\n只能恢复普通部件的形状、颜色与面名称，立方体、放样等特征的修改无法恢复，新建的部件将排在树的末尾。"));
+        if (answer != QMessageBox::Yes)
+        {
+            Discard(doc);
+            return;
+        }
+        try
+        {
+            Recover(doc);
+        }
+        catch (...)
+        {
+            app::AbortCommand();
+            LOGGING_ERROR("Recover document failed.");
+        }
+    }
+
+    std::filesystem::path RecoveryJournal::GetDirectory(const app::Document *doc)
+    {
+        if (!doc)
+            return {};
+        auto uid = doc->Uid.GetString();
+        if (uid.empty())
+            return {};
+        auto base = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+        if (base.isEmpty())
+            return {};
+
+        // 复制的文档Uid相同，再按文件的规范路径区分
+        std::string key(uid);
+        if (!doc->GetFileName().empty())
+        {
+            std::error_code ec;
+            auto path = std::filesystem::weakly_canonical(doc->GetFileName(), ec);
+            if (ec)
+                path = std::filesystem::absolute(doc->GetFileName(), ec);
+            auto normalized = QString::fromStdWString(path.wstring());
+#ifdef _WIN32
+            // Windows路径不区分大小写
+            normalized = normalized.toLower();
+#endif
+            auto hash = QCryptographicHash::hash(normalized.toUtf8(), QCryptographicHash::Sha1).toHex().left(16);
+            key += '_';
+            key += hash.toStdString();
+        }
+        return std::filesystem::path(base.toStdWString()) / "DevRecovery" / key;
+    }
+
+    std::map<std::uint32_t, std::filesystem::path> RecoveryJournal::ListDeltas(const std::filesystem::path &dir)
+    {
+        std::map<std::uint32_t, std::filesystem::path> deltas;
+        std::error_code ec;
+        if (dir.empty() || !std::filesystem::is_directory(dir, ec))
+            return deltas;
+        for (auto const &entry : std::filesystem::directory_iterator(dir, ec))
+        {
+            auto name = entry.path().filename().string();
+            // 未改名的临时文件是写入中断的增量，忽略
+            if (name.size() <= std::strlen(kDeltaPrefix) + std::strlen(kDeltaSuffix) ||
+                name.compare(0, std::strlen(kDeltaPrefix), kDeltaPrefix) != 0 ||
+                entry.path().extension() != kDeltaSuffix)
+                continue;
+            auto digits = name.substr(std::strlen(kDeltaPrefix), name.size() - std::strlen(kDeltaPrefix) - std::strlen(kDeltaSuffix));
+            try
+            {
+                deltas.emplace(static_cast<std::uint32_t>(std::stoul(digits)), entry.path());
+            }
+            catch (...)
+            {
+            }
+        }
+        return deltas;
+    }
+
+    bool RecoveryJournal::WriteDelta(const std::filesystem::path &file, const std::vector<Record> &records)
+    {
+        std::ofstream ofs(file, std::ios::binary | std::ios::trunc);
+        if (!ofs || !RecoveryDelta::Write(ofs, records))
+            return false;
+        ofs.flush();
+        return static_cast<bool>(ofs);
+    }
+
+    bool RecoveryJournal::ReadDelta(const std::filesystem::path &file, std::vector<Record> &records)
+    {
+        std::error_code ec;
+        auto file_size = std::filesystem::file_size(file, ec);
+        if (ec)
+            return false;
+        std::ifstream ifs(file, std::ios::binary);
+        return ifs && RecoveryDelta::Read(ifs, file_size, records);
+    }
+
+} // namespace Dev
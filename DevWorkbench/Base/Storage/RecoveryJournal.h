@@ -0,0 +1,103 @@
+#pragma once
+
+#include "RecoveryDelta.h"
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <boost/signals2.hpp>
+#include <tbb/task_group.h>
+
+class QTimer;
+
+namespace app {
+class Document;
+class DocumentObject;
+}
+
+namespace Dev {
+
+class PartCollection;
+
+/**
+ * @brief 部件修改的增量恢复日志
+ *
+ * 记录上次保存后新建、修改、删除过的普通部件（类型为app::DocumentObjectTopoShape），定时在GUI线程中只对这些部件做快照
+ * （TopoShape与颜色表复制的是共享数据的句柄），编码与写文件在TBB线程池中完成。
+ * 每次写出一个按序号命名的增量文件，先写临时文件再改名提交，写到一半的文件不会被读取。
+ * 文档保存后删除日志；重新打开文档时按序号合并所有增量并应用到部件上。
+ * 每次自动保存的耗时只与修改的部件数量有关，与文档大小无关。
+ * 只记录标签、形状（包括位置）、实体颜色、面颜色与面名称；立方体、放样等特征的类型与参数不记录，
+ * 恢复时新建的部件排在树的末尾。
+ * 所有打开的文档都已保存过、正在记录且没有未记录的特征修改时，通过AutoSaveControl停用主程序的整文档自动保存；
+ * 否则主程序的自动保存照常进行，其间GUI线程仍会停顿。
+ */
+class RecoveryJournal
+{
+  public:
+    using Operation = RecoveryDelta::Operation;
+    using Record = RecoveryDelta::Record;
+
+    static RecoveryJournal& GetInstance();
+
+    // 用户参数 BaseApp/Preferences/Mod/Dev/Document 下的 IncrementalAutoSave、IncrementalAutoSaveInterval（分钟）
+    static bool IsEnabled();
+
+    // 开始记录文档中部件的修改，重复调用无影响
+    void Attach(app::Document* doc, PartCollection* parts);
+    // 文档关闭前调用，等待写入完成并删除日志
+    void Detach(const app::Document* doc);
+
+    // 立即写出一次增量
+    void Flush(app::Document* doc);
+    // 删除已写出的增量，清空修改记录
+    void Discard(app::Document* doc);
+
+    bool HasRecovery(const app::Document* doc) const;
+    // 合并增量并应用到文档，返回应用的记录数
+    std::size_t Recover(app::Document* doc);
+    // 有可恢复的增量时询问用户，恢复或删除
+    void OfferRecovery(app::Document* doc);
+
+    // 以文档Uid与文件规范路径的散列命名，复制的文档不会共用日志
+    static std::filesystem::path GetDirectory(const app::Document* doc);
+    static bool WriteDelta(const std::filesystem::path& file, const std::vector<Record>& records);
+    static bool ReadDelta(const std::filesystem::path& file, std::vector<Record>& records);
+
+  private:
+    RecoveryJournal() = default;
+    ~RecoveryJournal();
+
+    struct Journal
+    {
+        app::Document* document = nullptr;
+        PartCollection* parts = nullptr;
+        std::vector<boost::signals2::scoped_connection> connections;
+        std::unordered_set<std::string> touched;
+        std::unordered_set<std::string> removed;
+        std::uint32_t sequence = 0;
+        // 上次保存后修改过日志不记录的特征，需要主程序的自动保存
+        bool uncovered = false;
+    };
+
+    void EnsureTimer();
+    void OnTimer();
+    void Touch(Journal& journal, const app::DocumentObject& obj);
+    // 特征对象无法按部件恢复，不记录
+    static bool IsJournaled(const app::DocumentObject& obj);
+    static std::map<std::uint32_t, std::filesystem::path> ListDeltas(const std::filesystem::path& dir);
+    // 重新判断日志能否代替主程序的自动保存，closing为正在关闭的文档
+    void UpdateAutoSave(const app::Document* closing = nullptr) const;
+
+  private:
+    QTimer* m_timer = nullptr;
+    std::unordered_map<const app::Document*, std::unique_ptr<Journal>> m_journals;
+    boost::signals2::scoped_connection m_new_document;
+    tbb::task_group m_group;
+};
+
+}  // namespace Dev
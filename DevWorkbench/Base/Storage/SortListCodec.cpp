@@ -0,0 +1,237 @@
+#include "SortListCodec.h"
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include <unordered_map>
+
+namespace Dev
+{
+    namespace
+    {
+        constexpr char kMagic[4] = {'D', 'V', 'S', 'L'};
+        constexpr std::uint32_t kVersion = 1;
+
+        class Output
+        {
+          public:
+            void PutU32(std::uint32_t value)
+            {
+                char bytes[4];
+                for (int i = 0; i < 4; ++i)
+                    bytes[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+                m_buffer.append(bytes, 4);
+            }
+
+            void PutString(std::string_view str)
+            {
+                PutU32(static_cast<std::uint32_t>(str.size()));
+                m_buffer.append(str.data(), str.size());
+            }
+
+            void PutBytes(const char *data, std::size_t size) { m_buffer.append(data, size); }
+
+            const std::string &Buffer() const { return m_buffer; }
+
+          private:
+            std::string m_buffer;
+        };
+
+        class Input
+        {
+          public:
+            explicit Input(std::string data)
+                : m_data(std::move(data))
+            {
+            }
+
+            bool GetU32(std::uint32_t &value)
+            {
+                if (m_data.size() - m_pos < 4)
+                    return false;
+                value = 0;
+                for (int i = 0; i < 4; ++i)
+                    value |= static_cast<std::uint32_t>(static_cast<unsigned char>(m_data[m_pos + i])) << (8 * i);
+                m_pos += 4;
+                return true;
+            }
+
+            bool GetString(std::string &str)
+            {
+                std::uint32_t size = 0;
+                if (!GetU32(size) || m_data.size() - m_pos < size)
+                    return false;
+                str.assign(m_data.data() + m_pos, size);
+                m_pos += size;
+                return true;
+            }
+
+            bool GetBytes(char *dst, std::size_t size)
+            {
+                if (m_data.size() - m_pos < size)
+                    return false;
+                // 空排序表的dst可能为空指针
+                if (size)
+                    std::memcpy(dst, m_data.data() + m_pos, size);
+                m_pos += size;
+                return true;
+            }
+
+            // 至少还有count个、每个min_size字节的元素，数量来自文件，分配前先检查
+            bool HasRoom(std::uint64_t count, std::size_t min_size) const
+            {
+                return count <= (m_data.size() - m_pos) / min_size;
+            }
+
+          private:
+            std::string m_data;
+            std::size_t m_pos = 0;
+        };
+
+        // 字符串到字符串表序号
+        class StringTable
+        {
+          public:
+            std::uint32_t Add(const std::string &str)
+            {
+                auto [it, inserted] = m_index.emplace(str, static_cast<std::uint32_t>(m_strings.size()));
+                if (inserted)
+                    m_strings.push_back(&it->first);
+                return it->second;
+            }
+
+            const std::vector<const std::string *> &Strings() const { return m_strings; }
+
+          private:
+            std::unordered_map<std::string, std::uint32_t> m_index;
+            std::vector<const std::string *> m_strings;
+        };
+
+        void CollectStrings(StringTable &table, const SortListCodec::SortList &list)
+        {
+            for (auto const &[name, vec] : list)
+            {
+                table.Add(name);
+                for (auto const &item : vec)
+                    table.Add(item);
+            }
+        }
+
+        void WriteSortList(Output &out, StringTable &table, const SortListCodec::SortList &list)
+        {
+            out.PutU32(static_cast<std::uint32_t>(list.size()));
+            std::vector<char> indices;
+            for (auto const &[name, vec] : list)
+            {
+                out.PutU32(table.Add(name));
+                out.PutU32(static_cast<std::uint32_t>(vec.size()));
+                // 序号数组整体写出
+                indices.resize(vec.size() * 4);
+                for (std::size_t k = 0; k < vec.size(); ++k)
+                {
+                    auto index = table.Add(vec[k]);
+                    for (int i = 0; i < 4; ++i)
+                        indices[k * 4 + i] = static_cast<char>((index >> (8 * i)) & 0xff);
+                }
+                out.PutBytes(indices.data(), indices.size());
+            }
+        }
+
+        bool ReadSortList(Input &in, const std::vector<std::string> &strings, SortListCodec::SortList &list)
+        {
+            std::uint32_t count = 0;
+            // 每项至少有名称序号与数组长度
+            if (!in.GetU32(count) || !in.HasRoom(count, 8))
+                return false;
+            std::vector<char> indices;
+            for (std::uint32_t n = 0; n < count; ++n)
+            {
+                std::uint32_t name = 0, size = 0;
+                if (!in.GetU32(name) || !in.GetU32(size) || name >= strings.size() || !in.HasRoom(size, 4))
+                    return false;
+                indices.resize(static_cast<std::size_t>(size) * 4);
+                if (!in.GetBytes(indices.data(), indices.size()))
+                    return false;
+
+                std::vector<std::string> vec;
+                vec.reserve(size);
+                for (std::uint32_t k = 0; k < size; ++k)
+                {
+                    std::uint32_t index = 0;
+                    for (int i = 0; i < 4; ++i)
+                        index |= static_cast<std::uint32_t>(static_cast<unsigned char>(indices[k * 4 + i])) << (8 * i);
+                    if (index >= strings.size())
+                        return false;
+                    vec.push_back(strings[index]);
+                }
+                list.emplace(strings[name], std::move(vec));
+            }
+            return true;
+        }
+    } // namespace
+
+    bool SortListCodec::Write(std::ostream &os, const Data &data)
+    {
+        StringTable table;
+        for (auto const &[key, list] : data.nav_sort_list)
+            CollectStrings(table, list);
+        CollectStrings(table, data.part_sort_list);
+
+        Output out;
+        out.PutBytes(kMagic, sizeof(kMagic));
+        out.PutU32(kVersion);
+        out.PutU32(static_cast<std::uint32_t>(table.Strings().size()));
+        for (auto str : table.Strings())
+            out.PutString(*str);
+
+        out.PutU32(static_cast<std::uint32_t>(data.nav_sort_list.size()));
+        for (auto const &[key, list] : data.nav_sort_list)
+        {
+            out.PutU32(static_cast<std::uint32_t>(key));
+            WriteSortList(out, table, list);
+        }
+        WriteSortList(out, table, data.part_sort_list);
+
+        auto const &buffer = out.Buffer();
+        os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        return static_cast<bool>(os);
+    }
+
+    bool SortListCodec::Read(std::istream &is, Data &data)
+    {
+        Input in(std::string((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>()));
+        char magic[sizeof(kMagic)];
+        std::uint32_t version = 0, string_count = 0;
+        if (!in.GetBytes(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0)
+            return false;
+        // 每个字符串至少有4字节的长度
+        if (!in.GetU32(version) || version > kVersion || !in.GetU32(string_count) || !in.HasRoom(string_count, 4))
+            return false;
+
+        std::vector<std::string> strings(string_count);
+        for (auto &str : strings)
+        {
+            if (!in.GetString(str))
+                return false;
+        }
+
+        Data result;
+        std::uint32_t nav_count = 0;
+        if (!in.GetU32(nav_count) || !in.HasRoom(nav_count, 8))
+            return false;
+        for (std::uint32_t n = 0; n < nav_count; ++n)
+        {
+            std::uint32_t key = 0;
+            SortList list;
+            if (!in.GetU32(key) || !ReadSortList(in, strings, list))
+                return false;
+            result.nav_sort_list.emplace(static_cast<int>(key), std::move(list));
+        }
+        if (!ReadSortList(in, strings, result.part_sort_list))
+            return false;
+
+        data = std::move(result);
+        return true;
+    }
+
+} // namespace Dev
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Dev {
+
+/**
+ * @brief 导航栏、部件排序表的二进制编码
+ *
+ * 所有名称先收集到字符串表中（长度前缀），排序表只保存字符串表中的序号数组，全部为小端序。
+ * 相同的部件名在多个排序表中只保存一次，读取时不需要逐个解析XML元素。
+ * 只依赖标准库，读取时所有数量都先与剩余字节数比较再分配。
+ * 是否使用由DevSetup按用户参数 BaseApp/Preferences/Mod/Dev/Document/BinarySortList 决定，关闭时仍按XML保存。
+ */
+class SortListCodec
+{
+  public:
+    using SortList = std::map<std::string, std::vector<std::string>>;
+
+    struct Data
+    {
+        std::map<int, SortList> nav_sort_list;
+        SortList part_sort_list;
+    };
+
+    static bool Write(std::ostream& os, const Data& data);
+    static bool Read(std::istream& is, Data& data);
+};
+
+}  // namespace Dev
@@ -0,0 +1,191 @@
+#include "SubShapeIndex.h"
+#include <App/DocumentObjectTopoShape.h>
+#include <Logging/Logging.h>
+#include <charconv>
+#include <topology/TopoExplorerTool.hpp>
+
+namespace Dev
+{
+    namespace
+    {
+        // 子元素名称只有这三种类型
+        constexpr AMCAX::ShapeType kSubTypes[] = {AMCAX::ShapeType::Face, AMCAX::ShapeType::Edge, AMCAX::ShapeType::Vertex};
+
+        int SubTypeSlot(AMCAX::ShapeType type)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                if (kSubTypes[i] == type)
+                    return i;
+            }
+            return -1;
+        }
+    } // namespace
+
+    SubElementId SubElementId::Parse(std::string_view sub_name)
+    {
+        // 允许传入"doc.obj.Face12"形式的完整名称，只取最后一段
+        if (auto pos = sub_name.rfind('.'); pos != std::string_view::npos)
+            sub_name.remove_prefix(pos + 1);
+
+        for (auto type : kSubTypes)
+        {
+            auto type_name = app::DocumentObjectTopoShape::GetShapeTypeName(type);
+            if (sub_name.size() <= type_name.size() || sub_name.substr(0, type_name.size()) != type_name)
+                continue;
+
+            int index = -1;
+            auto digits = sub_name.substr(type_name.size());
+            auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), index);
+            if (ec != std::errc() || ptr != digits.data() + digits.size() || index < 0)
+                return SubElementId();
+            return SubElementId{type, index};
+        }
+        return SubElementId();
+    }
+
+    std::string SubElementId::ToString() const
+    {
+        if (!IsValid())
+            return std::string();
+        std::string name(app::DocumentObjectTopoShape::GetShapeTypeName(type));
+        name += std::to_string(index);
+        return name;
+    }
+
+    SubShapeIndex &SubShapeIndex::GetInstance()
+    {
+        static SubShapeIndex instance;
+        return instance;
+    }
+
+    AMCAX::TopoShape SubShapeIndex::GetSubShape(const app::DocumentObjectTopoShape *object, SubElementId id)
+    {
+        if (!object || !id.IsValid())
+            return AMCAX::TopoShape();
+        auto shapes = Ensure(object, id.type);
+        if (!shapes)
+            return AMCAX::TopoShape();
+
+        int base = GetNameBase(object, id.type, *shapes);
+        if (base == kNoNameBase)
+        {
+            // 名称与集合序号对不上时逐个对照名称
+            try
+            {
+                for (int i = 0; i < shapes->size(); ++i)
+                {
+                    if (SubElementId::Parse(object->GetSubShapeID((*shapes)[i])) == id)
+                        return (*shapes)[i];
+                }
+            }
+            catch (...)
+            {
+            }
+            return AMCAX::TopoShape();
+        }
+        int position = id.index - base;
+        if (position < 0 || position >= shapes->size())
+            return AMCAX::TopoShape();
+        return (*shapes)[position];
+    }
+
+    SubElementId SubShapeIndex::GetSubElementId(const app::DocumentObjectTopoShape *object, const AMCAX::TopoShape &sub_shape)
+    {
+        if (!object || sub_shape.IsNull())
+            return SubElementId();
+        auto shapes = Ensure(object, sub_shape.Type());
+        if (!shapes)
+            return SubElementId();
+
+        int position = shapes->index(sub_shape);
+        if (position < 0)
+            return SubElementId();
+        int base = GetNameBase(object, sub_shape.Type(), *shapes);
+        if (base == kNoNameBase)
+            return SubElementId::Parse(object->GetSubShapeID(sub_shape));
+        return SubElementId{sub_shape.Type(), position + base};
+    }
+
+    void SubShapeIndex::Remove(const app::DocumentObjectTopoShape *object)
+    {
+        m_entries.erase(object);
+    }
+
+    void SubShapeIndex::Clear()
+    {
+        m_entries.clear();
+    }
+
+    const AMCAX::IndexSet<AMCAX::TopoShape> *SubShapeIndex::Ensure(const app::DocumentObjectTopoShape *object, AMCAX::ShapeType type)
+    {
+        AMCAX::IndexSet<AMCAX::TopoShape> *shapes = nullptr;
+        bool *built = nullptr;
+
+        auto &entry = m_entries[object];
+        const auto &shape = object->Shape.GetValue();
+        if (!entry.shape.IsEqual(shape))
+        {
+            // 形状已被替换，之前建立的集合全部作废
+            entry = Entry();
+            entry.shape = shape;
+        }
+        if (shape.IsNull())
+            return nullptr;
+
+        switch (type)
+        {
+        case AMCAX::ShapeType::Vertex:
+            shapes = &entry.vertices;
+            built = &entry.has_vertices;
+            break;
+        case AMCAX::ShapeType::Edge:
+            shapes = &entry.edges;
+            built = &entry.has_edges;
+            break;
+        case AMCAX::ShapeType::Face:
+            shapes = &entry.faces;
+            built = &entry.has_faces;
+            break;
+        default:
+            return nullptr;
+        }
+
+        if (!*built)
+        {
+            AMCAX::TopoExplorerTool::MapShapes(shape, type, *shapes);
+            *built = true;
+        }
+        return shapes;
+    }
+
+    int SubShapeIndex::GetNameBase(const app::DocumentObjectTopoShape *object, AMCAX::ShapeType type, const AMCAX::IndexSet<AMCAX::TopoShape> &shapes)
+    {
+        int slot = SubTypeSlot(type);
+        if (slot < 0)
+            return kNoNameBase;
+        // 在Ensure之后调用，记录一定存在
+        int &base = m_entries[object].name_base[slot];
+        if (base != kUnknownNameBase || shapes.size() == 0)
+            return base == kUnknownNameBase ? 0 : base;
+
+        // 名称的编号规则由DocumentObjectTopoShape决定，用首尾两个子形状的名称推算并相互印证
+        try
+        {
+            auto first = SubElementId::Parse(object->GetSubShapeID(shapes[0]));
+            auto last = SubElementId::Parse(object->GetSubShapeID(shapes[shapes.size() - 1]));
+            if (first.type == type && last.type == type && last.index - first.index == shapes.size() - 1)
+                base = first.index;
+            else
+                base = kNoNameBase;
+        }
+        catch (...)
+        {
+            base = kNoNameBase;
+        }
+        if (base == kNoNameBase)
+            LOGGING_WARN << "Sub-shape names of type " << app::DocumentObjectTopoShape::GetShapeTypeName(type) << " do not follow the index order, the sub-shape index is disabled for this type of the shape.";
+        return base;
+    }
+
+} // namespace Dev
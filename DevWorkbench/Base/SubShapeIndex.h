@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <common/IndexSet.hpp>
+#include <topology/TopoShape.hpp>
+
+namespace app {
+class DocumentObjectTopoShape;
+}
+
+namespace Dev {
+
+/**
+ * @brief 预先解析的子元素编号，如"Face12"
+ *
+ * 只保存类型与名称中的序号，比较、哈希和查找子形状时无需再拆分字符串。
+ */
+struct SubElementId
+{
+    AMCAX::ShapeType type = AMCAX::ShapeType::Shape;
+    int index = -1;  // 名称中的序号
+
+    bool IsValid() const { return index >= 0 && type != AMCAX::ShapeType::Shape; }
+
+    // 解析"Face12"形式的子元素名称，无法解析时返回无效编号
+    static SubElementId Parse(std::string_view sub_name);
+    std::string ToString() const;
+
+    bool operator==(const SubElementId& other) const { return type == other.type && index == other.index; }
+    bool operator!=(const SubElementId& other) const { return !(*this == other); }
+
+    struct Hash
+    {
+        std::size_t operator()(const SubElementId& id) const
+        {
+            return std::hash<long long>{}((static_cast<long long>(id.type) << 32) | static_cast<unsigned int>(id.index));
+        }
+    };
+};
+
+/**
+ * @brief 部件子形状的延迟索引
+ *
+ * 形状变化时不重建索引，只在第一次按类型查询时建立该类型的子形状集合；
+ * 查询时比较部件当前形状与建立索引时的形状，不同则作废重建。
+ * 部件删除时由PartCollection调用Remove释放。
+ */
+class SubShapeIndex
+{
+  public:
+    static SubShapeIndex& GetInstance();
+
+    AMCAX::TopoShape GetSubShape(const app::DocumentObjectTopoShape* object, SubElementId id);
+    SubElementId GetSubElementId(const app::DocumentObjectTopoShape* object, const AMCAX::TopoShape& sub_shape);
+
+    void Remove(const app::DocumentObjectTopoShape* object);
+    void Clear();
+
+  private:
+    SubShapeIndex() = default;
+
+    static constexpr int kUnknownNameBase = -1;
+    static constexpr int kNoNameBase = -2;
+
+    struct Entry
+    {
+        AMCAX::TopoShape shape;
+        AMCAX::IndexSet<AMCAX::TopoShape> vertices, edges, faces;
+        bool has_vertices = false, has_edges = false, has_faces = false;
+        // 依次为面、边、点，随形状一起作废
+        std::array<int, 3> name_base = {kUnknownNameBase, kUnknownNameBase, kUnknownNameBase};
+    };
+
+    const AMCAX::IndexSet<AMCAX::TopoShape>* Ensure(const app::DocumentObjectTopoShape* object, AMCAX::ShapeType type);
+    // 名称序号相对集合序号的偏移，每个部件的当前形状按类型分别在第一次使用时与GetSubShapeID的结果对照得到：
+    // 集合首尾两个子形状的名称都符合同一偏移才采用，否则该形状的这一类型不再走索引，返回kNoNameBase
+    int GetNameBase(const app::DocumentObjectTopoShape* object, AMCAX::ShapeType type, const AMCAX::IndexSet<AMCAX::TopoShape>& shapes);
+
+  private:
+    std::unordered_map<const app::DocumentObjectTopoShape*, Entry> m_entries;
+};
+
+}  // namespace Dev
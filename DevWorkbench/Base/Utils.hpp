@@ -1,6 +1,5 @@
 #include <string>
-#include <vector>
-#include <sstream>
+#include <Base/ElementName.h>
 
 namespace Dev{
 class Utils
@@ -8,23 +7,10 @@ class Utils
     public:
     static std::string GetSubNameByFullName(const std::string &fullName)
     {
-        std::string sub_name = "";
-        std::vector<std::string> name_list;
-
-        std::stringstream ss(fullName);
-        std::string name;
-
-        while (std::getline(ss, name, '.'))
-        {
-            name_list.push_back(name);
-        }
-
-        if (name_list.size() == 3)
-        {
-            sub_name = name_list[2];
-            return sub_name;
-        }
-        return "";
+        FullNameView name;
+        if (!FullNameView::Parse(fullName, name))
+            return "";
+        return std::string(name.sub);
     }
 };
 }
@@ -10,13 +10,13 @@
 #include <Base/Object/BoxObject.h>
 #include <modeling/MakeBox.hpp>
 
-PFC_TYPESYSTEM_IMPL(Dev::ViewProviderBox, gui::ViewProviderDocumentObjectTopoShape)
+PFC_TYPESYSTEM_IMPL(Dev::ViewProviderBox, Dev::ViewProviderPart)
 
 namespace Dev
 {
 
     ViewProviderBox::ViewProviderBox()
-        : ViewProviderDocumentObjectTopoShape()
+        : ViewProviderPart()
     {
     }
 
@@ -1,9 +1,9 @@
 #pragma once
-#include <Gui/ViewProvider/ViewProviderDocumentObjectTopoShape.h>
+#include <Base/ViewProvider/ViewProviderPart.h>
 
 namespace Dev {
 
-class ViewProviderBox : public gui::ViewProviderDocumentObjectTopoShape
+class ViewProviderBox : public Dev::ViewProviderPart
 {
     PFC_TYPESYSTEM_DECL_WITH_OVERRIDE()
 
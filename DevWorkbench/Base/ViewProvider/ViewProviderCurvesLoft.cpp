@@ -10,13 +10,13 @@
 #include <Base/Object/BoxObject.h>
 #include <modeling/MakeBox.hpp>
 
-PFC_TYPESYSTEM_IMPL(Dev::ViewProviderCurvesLoft, gui::ViewProviderDocumentObjectTopoShape)
+PFC_TYPESYSTEM_IMPL(Dev::ViewProviderCurvesLoft, Dev::ViewProviderPart)
 
 namespace Dev
 {
 
     ViewProviderCurvesLoft::ViewProviderCurvesLoft()
-        : ViewProviderDocumentObjectTopoShape()
+        : ViewProviderPart()
     {
     }
 
@@ -0,0 +1,256 @@
+#include "ViewProviderPart.h"
+#include <App/Application.h>
+#include <App/DocumentObjectTopoShape.h>
+#include <Base/Parameter.h>
+#include <Base/Render/FlatMeshBuilder.h>
+#include <Base/Render/LodManager.h>
+#include <Base/Render/TessellationCache.h>
+#include <Base/Render/TessellationWorker.h>
+#include <Logging/Logging.h>
+#include <algorithm>
+
+PFC_TYPESYSTEM_IMPL(Dev::ViewProviderPart, gui::ViewProviderDocumentObjectTopoShape)
+
+namespace Dev
+{
+    namespace
+    {
+        // 用户参数只在GUI线程读取，工作线程只使用传入的Parameters
+        FlatMeshBuilder::Parameters ReadParameters(FlatMeshBuilder::MeshLevel level)
+        {
+            auto parameters = FlatMeshBuilder::Parameters::ForLevel(level);
+            parameters.parallel = FlatMeshBuilder::IsParallelEnabled();
+            parameters.disk_cache = TessellationCache::IsEnabled();
+            // 缓存实例构造时读取参数并整理目录
+            if (parameters.disk_cache)
+                TessellationCache::GetInstance();
+            return parameters;
+        }
+    } // namespace
+
+    ViewProviderPart::ViewProviderPart()
+        : ViewProviderDocumentObjectTopoShape(),
+          m_level(MeshLevel::Fine),
+          m_has_mesh(false),
+          m_bounds{0, 0, 0, 0, 0, 0},
+          m_has_bounds(false),
+          m_render_pending(false)
+    {
+        LodManager::GetInstance().Register(this);
+    }
+
+    ViewProviderPart::~ViewProviderPart()
+    {
+        TessellationWorker::GetInstance().Cancel(this);
+        LodManager::GetInstance().Unregister(this);
+    }
+
+    bool ViewProviderPart::IsFlatMeshEnabled()
+    {
+        auto grp = app::GetApplication().GetUserParameter().GetGroup("BaseApp/Preferences/Mod/Dev/Render");
+        if (!grp)
+            return true;
+        return grp->GetBool("FlatMesh", true);
+    }
+
+    void ViewProviderPart::UpdateData(const app::Property *prop)
+    {
+        auto object = GetObject<app::DocumentObjectTopoShape>();
+        if (object && prop == &object->Shape && IsFlatMeshEnabled())
+        {
+            if (m_render != nullptr)
+            {
+                m_render_pending = false;
+                UpdateShapeRender();
+                return;
+            }
+            // 打开文档时形状在视图关联之前恢复，关联后由LodManager调用UpdatePendingRender
+            m_render_pending = true;
+            LodManager::GetInstance().RequestRender(this);
+        }
+        ViewProviderDocumentObjectTopoShape::UpdateData(prop);
+    }
+
+    bool ViewProviderPart::UpdatePendingRender()
+    {
+        if (!m_render_pending)
+            return true;
+        if (m_render == nullptr)
+            return false;
+        m_render_pending = false;
+        UpdateShapeRender();
+        return true;
+    }
+
+    FlatMeshInfo ViewProviderPart::GetFlatMeshInfo(bool isVertex, bool isEdge, bool isFace, MeshLevel level) const
+    {
+        auto object = GetObject<app::DocumentObjectTopoShape>();
+        if (!object)
+            return FlatMeshInfo();
+        return BuildFlatMesh(GetUuid(), object->Shape.GetValue(), ReadParameters(level), isVertex, isEdge, isFace);
+    }
+
+    FlatMeshInfo ViewProviderPart::BuildFlatMesh(const std::string &objId,
+                                                 const AMCAX::TopoShape &shape,
+                                                 const FlatMeshBuilder::Parameters &parameters,
+                                                 bool isVertex,
+                                                 bool isEdge,
+                                                 bool isFace)
+    {
+        FlatMeshBuilder builder(parameters);
+        if (parameters.disk_cache)
+            return TessellationCache::GetInstance().GetOrBuild(builder, objId, shape, isVertex, isEdge, isFace);
+        return builder.Build(objId, shape, isVertex, isEdge, isFace);
+    }
+
+    ViewProviderPart::MeshLevel ViewProviderPart::GetCurrentLevel() const
+    {
+        return m_level;
+    }
+
+    void ViewProviderPart::SetLevel(MeshLevel level)
+    {
+        if (level == m_level && m_has_mesh)
+            return;
+        // 正在生成的网格完成后再重新检查
+        if (TessellationWorker::GetInstance().IsPending(this))
+        {
+            LodManager::GetInstance().RequestUpdate(this);
+            return;
+        }
+        // 生成过的层次直接重新提交，不再网格化
+        if (auto &mesh = m_meshes[static_cast<std::size_t>(level)])
+        {
+            UploadMesh(*mesh);
+            m_level = level;
+            return;
+        }
+        auto object = GetObject<app::DocumentObjectTopoShape>();
+        if (!object)
+            return;
+        // 在后台生成，完成前继续显示当前层次
+        SubmitMesh(object->Shape.GetValue(), level);
+    }
+
+    bool ViewProviderPart::GetBoundingBox(double bounds[6]) const
+    {
+        if (!m_has_bounds)
+            return false;
+        std::copy(m_bounds, m_bounds + 6, bounds);
+        return true;
+    }
+
+    std::shared_ptr<AMCAXRender::CBasicRender> ViewProviderPart::GetRenderView() const
+    {
+        return m_render;
+    }
+
+    void ViewProviderPart::UpdateShapeRender()
+    {
+        try
+        {
+            auto object = GetObject<app::DocumentObjectTopoShape>();
+            if (!object)
+                return;
+
+            // 形状变化后之前各层次的网格都已失效
+            ClearMeshes();
+            // 启用细节层次时先提交粗网格，由LodManager根据相机切换到合适的层次
+            MeshLevel level = LodManager::IsEnabled() ? MeshLevel::Coarse : MeshLevel::Fine;
+            const AMCAX::TopoShape &shape = object->Shape.GetValue();
+            if (TessellationWorker::ShouldRunInBackground(shape))
+            {
+                RequestShapeRender(shape, level);
+                return;
+            }
+
+            // 同步生成的结果覆盖之前尚未完成的后台任务
+            TessellationWorker::GetInstance().Cancel(this);
+            ApplyMesh(level, GetFlatMeshInfo(true, true, true, level));
+        }
+        catch (...)
+        {
+            LOGGING_ERROR("Update part render data failed.");
+        }
+    }
+
+    void ViewProviderPart::RequestShapeRender(const AMCAX::TopoShape &shape, MeshLevel level)
+    {
+        // 占位网格就是形状的包围盒，后台生成期间LodManager即可按它选择层次
+        auto placeholder = FlatMeshBuilder::BuildBoundingBox(GetUuid(), shape);
+        m_has_bounds = placeholder.GetBoundingBox(m_bounds);
+        m_has_mesh = false;
+        UploadMesh(placeholder);
+        SubmitMesh(shape, level);
+    }
+
+    void ViewProviderPart::SubmitMesh(const AMCAX::TopoShape &shape, MeshLevel level)
+    {
+        // 工作线程在拓扑副本上网格化，不修改文档中形状的三角网格
+        auto parameters = ReadParameters(level);
+        parameters.isolated = true;
+        TessellationWorker::GetInstance().Submit(
+            this,
+            [objId = GetUuid(), shape, parameters]()
+            { return BuildFlatMesh(objId, shape, parameters); },
+            [this, level](FlatMeshInfo &&mesh)
+            {
+                try
+                {
+                    ApplyMesh(level, std::move(mesh));
+                    if (m_render && m_render->entityManage)
+                        m_render->entityManage->DoRepaint();
+                }
+                catch (...)
+                {
+                    LOGGING_ERROR("Update part render data failed.");
+                }
+            });
+    }
+
+    void ViewProviderPart::ApplyMesh(MeshLevel level, FlatMeshInfo &&mesh)
+    {
+        auto &stored = m_meshes[static_cast<std::size_t>(level)];
+        stored = std::move(mesh);
+        m_has_bounds = stored->GetBoundingBox(m_bounds);
+        UploadMesh(*stored);
+        m_has_mesh = true;
+        m_level = level;
+        if (level != MeshLevel::Fine)
+            LodManager::GetInstance().RequestUpdate(this);
+    }
+
+    void ViewProviderPart::ClearMeshes()
+    {
+        for (auto &mesh : m_meshes)
+            mesh.reset();
+    }
+
+    void ViewProviderPart::UploadMesh(const FlatMeshInfo &mesh)
+    {
+        if (!m_render_id.empty())
+        {
+            m_render->entityManage->Remove(m_render_id);
+            m_render_id.clear();
+        }
+        if (mesh.IsEmpty())
+            return;
+
+        m_render_id = AddRender(mesh.ToCAXMeshInfo());
+        RefreshDisplayState();
+    }
+
+    void ViewProviderPart::RefreshDisplayState()
+    {
+        auto object = GetObject<app::DocumentObjectTopoShape>();
+        if (!object || m_render_id.empty())
+            return;
+
+        ViewProviderDocumentObjectTopoShape::UpdateData(&object->SolidColor);
+        ViewProviderDocumentObjectTopoShape::UpdateData(&object->FaceColors);
+        OnPropertyChanged(&Material);
+        OnPropertyChanged(&FaceOpacities);
+        m_render->entityManage->SetEntityVisble(m_render_id, Visibility.GetValue());
+    }
+
+} // namespace Dev
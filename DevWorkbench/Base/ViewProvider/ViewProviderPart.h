@@ -0,0 +1,81 @@
+#pragma once
+#include <array>
+#include <memory>
+#include <optional>
+#include <Base/Render/FlatMeshBuilder.h>
+#include <Base/Render/FlatMeshInfo.h>
+#include <Gui/ViewProvider/ViewProviderDocumentObjectTopoShape.h>
+
+namespace Dev {
+
+/**
+ * @brief 部件的视图提供者
+ *
+ * 形状变化时用FlatMeshBuilder生成连续内存的网格，提交给渲染端时转换为CAXMeshInfo。
+ * 各层次生成过的FlatMeshInfo保留到形状再次变化，切换回这些层次时直接重新提交，不再网格化。
+ * 关闭用户参数 BaseApp/Preferences/Mod/Dev/Render/FlatMesh 时退回到基类的GetMeshInfo流程。
+ * 启用细节层次时先提交粗网格，其余层次由LodManager按需在后台生成，完成后切换。
+ * 较大的形状在后台生成网格，完成前显示包围盒。
+ * 打开文档时形状在关联视图之前恢复，此时只做标记，关联视图后再经同一流程生成网格，
+ * 替换SDK生成的网格，使重新打开的部件同样使用磁盘缓存与细节层次。
+ */
+class ViewProviderPart : public gui::ViewProviderDocumentObjectTopoShape
+{
+    PFC_TYPESYSTEM_DECL_WITH_OVERRIDE()
+
+  public:
+    ViewProviderPart();
+    ~ViewProviderPart() override;
+
+    void UpdateData(const app::Property*) override;
+
+    using MeshLevel = FlatMeshBuilder::MeshLevel;
+
+    // 对应GetMeshInfo的连续内存版本
+    FlatMeshInfo GetFlatMeshInfo(bool isVertex = true,
+                                 bool isEdge = true,
+                                 bool isFace = true,
+                                 MeshLevel level = MeshLevel::Fine) const;
+    MeshLevel GetCurrentLevel() const;
+    // 切换到指定层次。未生成过的层次在后台生成，完成后切换，此前继续显示当前层次
+    void SetLevel(MeshLevel level);
+    // 形状的包围盒，依次为xmin,ymin,zmin,xmax,ymax,zmax
+    bool GetBoundingBox(double bounds[6]) const;
+    std::shared_ptr<AMCAXRender::CBasicRender> GetRenderView() const;
+    // 关联视图前恢复的形状在此生成网格，仍未关联视图时返回false
+    bool UpdatePendingRender();
+
+    static bool IsFlatMeshEnabled();
+    // 不访问文档对象与用户参数，可在工作线程调用
+    static FlatMeshInfo BuildFlatMesh(const std::string& objId,
+                                      const AMCAX::TopoShape& shape,
+                                      const FlatMeshBuilder::Parameters& parameters,
+                                      bool isVertex = true,
+                                      bool isEdge = true,
+                                      bool isFace = true);
+
+  protected:
+    void UpdateShapeRender();
+    // 先显示包围盒，网格在后台生成后再替换
+    void RequestShapeRender(const AMCAX::TopoShape& shape, MeshLevel level);
+    // 提交后台网格生成，完成后在GUI线程调用ApplyMesh
+    void SubmitMesh(const AMCAX::TopoShape& shape, MeshLevel level);
+    void ApplyMesh(MeshLevel level, FlatMeshInfo&& mesh);
+    void ClearMeshes();
+    void UploadMesh(const FlatMeshInfo& mesh);
+    // 渲染实体重建后恢复颜色、可见性等显示状态
+    void RefreshDisplayState();
+
+  protected:
+    MeshLevel m_level;
+    // 当前形状各层次已生成的网格
+    std::array<std::optional<FlatMeshInfo>, static_cast<std::size_t>(MeshLevel::Count)> m_meshes;
+    // 当前显示的是完整网格，而不是包围盒占位或空网格
+    bool m_has_mesh;
+    double m_bounds[6];
+    bool m_has_bounds;
+    // 形状更新时尚未关联视图，等待UpdatePendingRender
+    bool m_render_pending;
+};
+
+}  // namespace Dev
@@ -13,13 +13,13 @@
 #ifdef GetObject
 #undef GetObject
 #endif
-PFC_TYPESYSTEM_IMPL(Dev::ViewProviderRenderDistance, gui::ViewProviderDocumentObjectTopoShape)
+PFC_TYPESYSTEM_IMPL(Dev::ViewProviderRenderDistance, Dev::ViewProviderPart)
 
 namespace Dev
 {
 
     ViewProviderRenderDistance::ViewProviderRenderDistance()
-        : ViewProviderDocumentObjectTopoShape()
+        : ViewProviderPart()
     {
     }
 
@@ -37,7 +37,7 @@ namespace Dev
     void ViewProviderRenderDistance::UpdateData(const app::Property *prop)
     {
         auto object = GetObject<RenderDistanceObject>();
-        ViewProviderDocumentObjectTopoShape::UpdateData(prop);
+        ViewProviderPart::UpdateData(prop);
 
         if (prop == &Visibility || prop == object->GetPropertyFloat("point1x")|| prop == object->GetPropertyFloat("point1y")|| prop == object->GetPropertyFloat("point1z")|| prop == object->GetPropertyFloat("point2x")|| prop == object->GetPropertyFloat("point2y")|| prop == object->GetPropertyFloat("point2z"))
         {
@@ -92,7 +92,7 @@ namespace Dev
 
     void ViewProviderRenderDistance::FinishRestore()
     {
-        ViewProviderDocumentObjectTopoShape::FinishRestore();
+        ViewProviderPart::FinishRestore();
         UpdateData(&Visibility);
     }
     void ViewProviderRenderDistance::DeleteFromView()
@@ -1,10 +1,10 @@
 #pragma once
-#include <Gui/ViewProvider/ViewProviderDocumentObjectTopoShape.h>
+#include <Base/ViewProvider/ViewProviderPart.h>
 
 namespace Dev
 {
 
-  class ViewProviderRenderDistance : public gui::ViewProviderDocumentObjectTopoShape
+  class ViewProviderRenderDistance : public Dev::ViewProviderPart
   {
     PFC_TYPESYSTEM_DECL_WITH_OVERRIDE()
 
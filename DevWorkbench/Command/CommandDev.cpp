@@ -10,6 +10,7 @@
 #include <App/Application.h>
 #include <Gui/Selection/Selection.h>
 #include <App/Document.h>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <occtio/OCCTTool.hpp>
@@ -26,7 +27,10 @@
 #include <Base/Tools.h>
 #include <App/DocumentObjectTopoShape.h>
 #include <Base/DevSetup.h>
+#include <Base/FaceAttributeIndex.h>
+#include <Base/SubShapeIndex.h>
 #include <Base/Object/CurvesLoftObject.h>
+#include <Base/Object/FeatureRecompute.h>
 #include <Gui/Document.h>
 #include <Gui/ViewProvider/ViewProviderDocumentObjectTopoShape.h>
 #include <App/DocumentObjectTopoShape.h>
@@ -35,6 +39,8 @@
 #include <Gui/RenderDistanceDialog.h>
 #include <Gui/ViewProvider/ViewProviderDocumentObject.h>
 #include <Base/Utils.hpp>
+#include <Base/Import/ImportGuard.h>
+#include <Base/Import/StepImporter.h>
 
 namespace Dev
 {
@@ -72,6 +78,8 @@ namespace Dev
             QStringList fileList = QFileDialog::getOpenFileNames(gui::GetMainWindow(), QObject::tr("Import file"), ".", "all (*.brep *.step *.stp *Step *Stp);;STEP(*.step *.stp *Step *Stp);;BREP(*.brep)");
             if (!fileList.isEmpty())
             {
+                // 导入期间会处理事件，推迟定时器中对文档的访问
+                ImportGuard guard;
                 app::OpenCommand(QObject::tr("导入").toStdString());
                 for (const QString &filepath : fileList)
                 {
@@ -80,12 +88,12 @@ namespace Dev
                     if (fileInfo.exists() && fileInfo.isFile())
                     {
                         std::filesystem::path std_path = std::filesystem::path(filepath.toStdWString());
-                        std::ifstream ifs(std_path);
                         AMCAX::TopoShape shape;
 
                         QString suffix = fileInfo.suffix().toLower();
                         if (suffix == "brep")
                         {
+                            std::ifstream ifs(std_path);
                             if (!AMCAX::OCCTIO::OCCTTool::Read(shape, ifs))
                             {
                                 continue;
@@ -97,184 +105,9 @@ namespace Dev
                         }
                         else if (suffix == "step" || suffix == "stp")
                         {
-                            AMCAX::STEP::STEPStyledReader reader(ifs);
-                            if (!reader.Read())
-                                continue;
-
-                            auto ds = reader.GetProducts();
-                            AMCAX::STEP::STEPTool::FlattenInplace(ds);
-
-                            for (auto const &shape_data : ds)
-                            {
-                                if (shape_data->ShapesSize() > 0)
-                                {
-                                    // 获取类型
-                                    auto &represent = shape_data->ShapeRepresentations().front();
-                                    bool isWireFrame = (represent == AMCAX::STEP::ShapeRepresentationType::GEOMETRICALLY_BOUNDED_WIREFRAME_SHAPE_REPRESENTATION);
-                                    std::string name = base::Tools::DecodeEncodedUnicode(shape_data->ProductName());
-                                    name.erase(std::remove(name.begin(), name.end(), '\n'), name.end());
-                                    auto shape = shape_data->Shapes().front();
-                                    auto shape_type = shape.Type();
-                                    if (shape_type == AMCAX::ShapeType::Compound && !isWireFrame)
-                                    {
-                                        int i = 0;
-                                        for (auto iter = AMCAX::TopoIterator(shape); iter.More(); iter.Next())
-                                        {
-                                            auto sub_shape = iter.Value();
-                                            app::DocumentObjectTopoShape *object = DevSetup::GetCurDevSetup()->AddPart(name + "_" + std::to_string(i++))->SafeDownCast<app::DocumentObjectTopoShape>();
-                                            object->Shape.SetValue(sub_shape);
-                                            gui::ViewProviderDocumentObjectTopoShape *object_view_provider = nullptr;
-                                            auto view_provider = gui::GetGuiApplication()->GetViewProvider(object);
-                                            if (view_provider != nullptr)
-                                            {
-                                                object_view_provider = view_provider->SafeDownCast<gui::ViewProviderDocumentObjectTopoShape>();
-                                            }
-
-                                            auto &pcs = shape_data->PropertyAt(0);
-                                            {
-                                                auto it = std::find_if(pcs.begin(), pcs.end(), [&](const auto &pr)
-                                                                       { return pr.first.IsSame(sub_shape); });
-                                                if (it != pcs.end())
-                                                {
-                                                    auto &prop = it->second;
-                                                    auto shapestyle = prop.GetShapeStyle();
-                                                    if (shapestyle.SurfaceStyleHasValue())
-                                                    {
-                                                        auto surfacestyle = shapestyle.GetColor();
-                                                        if (surfacestyle.IsValidRGB())
-                                                        {
-                                                            object->SolidColor.SetValue(app::Color(surfacestyle.R(), surfacestyle.G(), surfacestyle.B(), surfacestyle.A()));
-                                                        }
-                                                    }
-                                                }
-                                            }
-                                            std::vector<std::pair<AMCAX::TopoShape, app::Color>> colors;
-                                            std::map<std::string, std::string> face_names;
-                                            std::map<std::string, double> face_opacities;
-
-                                            AMCAX::IndexSet<AMCAX::TopoShape> shapeFaces_;
-                                            AMCAX::TopoExplorerTool::MapShapes(sub_shape, AMCAX::ShapeType::Face, shapeFaces_);
-                                            for (int j = 0; j < shapeFaces_.size(); ++j)
-                                            {
-                                                const AMCAX::TopoFace &sub_face = static_cast<const AMCAX::TopoFace &>(shapeFaces_[j]);
-                                                auto it = std::find_if(pcs.begin(), pcs.end(), [&](const auto &pr)
-                                                                       { return pr.first.IsSame(sub_face); });
-                                                if (it != pcs.end())
-                                                {
-                                                    if (it->first.Type() == AMCAX::ShapeType::Face)
-                                                    {
-                                                        std::string face_id;
-                                                        try
-                                                        {
-                                                            auto shape_full_name = object->GetSubShapeID(it->first);
-                                                            face_id = Utils::GetSubNameByFullName(shape_full_name);
-                                                        }
-                                                        catch (...)
-                                                        {
-                                                            continue;
-                                                        }
-
-                                                        auto &prop = it->second;
-                                                        auto shapestyle = prop.GetShapeStyle();
-                                                        if (shapestyle.SurfaceStyleHasValue())
-                                                        {
-                                                            auto surfacestyle = shapestyle.GetColor();
-                                                            if (surfacestyle.IsValidRGB())
-                                                            {
-                                                                colors.emplace_back(it->first, app::Color(surfacestyle.R(), surfacestyle.G(), surfacestyle.B(), surfacestyle.A()));
-                                                                if (!face_id.empty())
-                                                                    face_opacities[face_id] = surfacestyle.A();
-                                                            }
-                                                        }
-                                                        if (prop.NameHasValue())
-                                                        {
-                                                            if (!face_id.empty())
-                                                                face_names[face_id] = prop.Name();
-                                                        }
-                                                    }
-                                                }
-                                            }
-
-                                            object->SetFaceColors(colors);
-                                            object->SetFaceNames(face_names);
-                                            if (object_view_provider != nullptr)
-                                                object_view_provider->SetFaceOpacities(face_opacities);
-                                        }
-                                    }
-                                    else
-                                    {
-                                        app::DocumentObjectTopoShape *object = DevSetup::GetCurDevSetup()->AddPart(name, isWireFrame)->SafeDownCast<app::DocumentObjectTopoShape>();
-                                        gui::ViewProviderDocumentObjectTopoShape *object_view_provider = nullptr;
-                                        auto view_provider = gui::GetGuiApplication()->GetViewProvider(object);
-                                        if (view_provider != nullptr)
-                                        {
-                                            object_view_provider = view_provider->SafeDownCast<gui::ViewProviderDocumentObjectTopoShape>();
-                                        }
-                                        object->Shape.SetValue(shape);
-
-                                        AMCAX::IndexSet<AMCAX::TopoShape> shapeFaces_;
-                                        AMCAX::TopoExplorerTool::MapShapes(shape, AMCAX::ShapeType::Face, shapeFaces_);
-                                        std::vector<std::pair<AMCAX::TopoShape, app::Color>> colors;
-                                        std::map<std::string, std::string> face_names;
-                                        std::map<std::string, double> face_opacities;
-                                        auto &pcs = shape_data->PropertyAt(0);
-                                        {
-                                            auto it = std::find_if(pcs.begin(), pcs.end(), [&](const auto &pr)
-                                                                   { return pr.first.IsSame(shape); });
-                                            if (it != pcs.end())
-                                            {
-                                                auto &prop = it->second;
-                                                auto shapestyle = prop.GetShapeStyle();
-                                                if (shapestyle.SurfaceStyleHasValue())
-                                                {
-                                                    auto surfacestyle = shapestyle.GetColor();
-                                                    if (surfacestyle.IsValidRGB())
-                                                    {
-                                                        object->SolidColor.SetValue(app::Color(surfacestyle.R(), surfacestyle.G(), surfacestyle.B(), surfacestyle.A()));
-                                                    }
-                                                }
-                                            }
-                                        }
-                                        for (auto &&[pcs_shape, pcs_prop] : pcs)
-                                        {
-                                            if (pcs_shape.Type() == AMCAX::ShapeType::Face)
-                                            {
-                                                std::string face_id;
-                                                try
-                                                {
-                                                    auto shape_full_name = object->GetSubShapeID(pcs_shape);
-                                                    face_id = Utils::GetSubNameByFullName(shape_full_name);
-                                                }
-                                                catch (...)
-                                                {
-                                                    continue;
-                                                }
-
-                                                auto shapestyle = pcs_prop.GetShapeStyle();
-                                                if (shapestyle.SurfaceStyleHasValue())
-                                                {
-                                                    auto surfacestyle = shapestyle.GetColor();
-                                                    if (surfacestyle.IsValidRGB())
-                                                    {
-                                                        colors.emplace_back(pcs_shape, app::Color(surfacestyle.R(), surfacestyle.G(), surfacestyle.B(), surfacestyle.A()));
-                                                        if (!face_id.empty())
-                                                            face_opacities[face_id] = surfacestyle.A();
-                                                    }
-                                                }
-                                                if (pcs_shape.Type() == AMCAX::ShapeType::Face && pcs_prop.NameHasValue())
-                                                {
-                                                    if (!face_id.empty())
-                                                        face_names[face_id] = pcs_prop.Name();
-                                                }
-                                            }
-                                        }
-                                        object->SetFaceColors(colors);
-                                        object->SetFaceNames(face_names);
-                                        if (object_view_provider != nullptr)
-                                            object_view_provider->SetFaceOpacities(face_opacities);
-                                    }
-                                }
-                            }
+                            StepImporter importer;
+                            if (!importer.Import(std_path))
+                                LOGGING_ERROR("Import STEP file failed.");
                         }
                     }
                 }
@@ -463,6 +296,137 @@ namespace Dev
         return true;
     }
 
+    //===========================================================================
+    // 重新计算 Dev_Recompute
+    //===========================================================================
+
+    DEF_STD_CMD_A(DevRecompute)
+
+    DevRecompute::DevRecompute()
+        : Command("Dev_Recompute")
+    {
+        m_group = QT_TR_NOOP("Dev");
+        m_menuText = QT_TR_NOOP("重新计算");
+        m_toolTipText = QT_TR_NOOP("重新计算");
+        m_whatsThis = "重新计算";
+        m_statusTip = QT_TR_NOOP("重新计算");
+        m_pixmap = ":icon/toolbar/recompute.png";
+        m_type = 0;
+    }
+
+    void DevRecompute::Activated(int iMsg)
+    {
+        Q_UNUSED(iMsg);
+        try
+        {
+            auto doc = app::GetApplication().GetActiveDocument();
+            if (!doc)
+                return;
+
+            std::vector<DevObject *> features;
+            for (auto obj : doc->GetObjectsOfType(DevObject::GetClassType()))
+            {
+                if (auto feature = dynamic_cast<DevObject *>(obj))
+                    features.push_back(feature);
+            }
+            if (features.empty())
+                return;
+
+            app::OpenCommand(QObject::tr("重新计算").toStdString());
+            auto timings = FeatureRecompute::Recompute(features);
+            // 没有被修改的特征时不留下空的撤销步骤
+            if (timings.empty())
+                app::AbortCommand();
+            else
+                app::CommitCommand();
+
+            for (auto const &timing : timings)
+            {
+                LOGGING_DEBUG << timing.object->Label.GetValue() << " : recompute " << timing.milliseconds << " ms"
+                              << (timing.succeeded ? "" : " (failed)");
+            }
+        }
+        catch (...)
+        {
+            LOGGING_ERROR("Recompute Command Error.");
+        }
+    }
+
+    bool DevRecompute::IsActive()
+    {
+        return app::GetApplication().GetActiveDocument();
+    }
+
+    //===========================================================================
+    // 选择同色面 Dev_SelectFacesByColor
+    //===========================================================================
+
+    DEF_STD_CMD_A(SelectFacesByColor)
+
+    SelectFacesByColor::SelectFacesByColor()
+        : Command("Dev_SelectFacesByColor")
+    {
+        m_group = QT_TR_NOOP("Dev");
+        m_menuText = QT_TR_NOOP("选择同色面");
+        m_toolTipText = QT_TR_NOOP("选择与已选面颜色相同的面");
+        m_whatsThis = "选择同色面";
+        m_statusTip = QT_TR_NOOP("选择与已选面颜色相同的面");
+        m_pixmap = ":icon/toolbar/select-face.png";
+        m_type = 0;
+    }
+
+    void SelectFacesByColor::Activated(int iMsg)
+    {
+        Q_UNUSED(iMsg);
+        try
+        {
+            auto doc = app::GetApplication().GetActiveDocument();
+            if (!doc)
+                return;
+
+            auto &index = FaceAttributeIndex::GetInstance();
+            auto &sub_shapes = SubShapeIndex::GetInstance();
+            for (auto object : gui::Selection().GetObjectsOfTypeInSelecting<app::DocumentObjectTopoShape>(doc->GetName()))
+            {
+                auto const &colors = object->FaceColors.GetValues();
+                std::vector<std::string> sub_names;
+                // 多个已选面颜色相同时只查找一次，不同颜色的面互不重复
+                std::vector<app::Color> searched;
+                for (auto sub_name : gui::Selection().GetSubNamesOfObjectInSelecting(object->GetNameInDocument(), doc->GetName()))
+                {
+                    auto id = SubElementId::Parse(sub_name);
+                    if (!id.IsValid() || id.type != AMCAX::ShapeType::Face)
+                        continue;
+                    auto color = colors.find(id.index);
+                    if (color == colors.end() || std::find(searched.begin(), searched.end(), color->second) != searched.end())
+                        continue;
+                    searched.push_back(color->second);
+
+                    // 同一颜色的面只在索引中查找，不扫描FaceColors
+                    for (auto const &face : index.FindFacesByColor(object, color->second))
+                    {
+                        auto face_id = sub_shapes.GetSubElementId(object, face);
+                        if (face_id.IsValid())
+                            sub_names.push_back(face_id.ToString());
+                    }
+                }
+                if (!sub_names.empty())
+                    gui::Selection().AddSelectings(doc->GetName(), object->GetNameInDocument(), sub_names);
+            }
+        }
+        catch (...)
+        {
+            LOGGING_ERROR("SelectFacesByColor Command Error.");
+        }
+    }
+
+    bool SelectFacesByColor::IsActive()
+    {
+        if (!gui::GetGuiApplication()->ActiveDocument())
+            return false;
+        return gui::Selection().HasSelection();
+    }
+
     //===========================================================================
     // Dev_EditDisplay
     //===========================================================================
@@ -512,5 +476,7 @@ namespace Dev
         commandMgr.AddCommand(new CreateBox());
         commandMgr.AddCommand(new CreateCurvesLoft());
         commandMgr.AddCommand(new CreateRenderDistance());
+        commandMgr.AddCommand(new DevRecompute());
+        commandMgr.AddCommand(new SelectFacesByColor());
     }
 } // namespace Dev
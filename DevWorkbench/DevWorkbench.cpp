@@ -85,7 +85,7 @@ namespace Dev
             gui::ToolBarItem *wave = new gui::ToolBarItem(root, "Dev");
 
             gui::ToolBarItem *base = new gui::ToolBarItem(wave, "基本");
-            *base << "Dev_Import" << "Dev_Export" << "Dev_CreateBox" << "Dev_CreateCurvesLoft" << "Dev_CreateRenderDistance";
+            *base << "Dev_Import" << "Dev_Export" << "Dev_CreateBox" << "Dev_CreateCurvesLoft" << "Dev_CreateRenderDistance" << "Dev_Recompute" << "Dev_SelectFacesByColor";
         }
 
         return root;
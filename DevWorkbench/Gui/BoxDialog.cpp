@@ -4,6 +4,9 @@
 #include <App/Properties/PropertyInteger.h>
 #include <App/Properties/PropertyVector.h>
 #include <Base/DevSetup.h>
+#include <Base/Import/ImportGuard.h>
+#include <Base/Object/FeatureBuilder.h>
+#include <Base/ShapeTransaction.h>
 #include <App/Properties/PropertyFloat.h>
 #include <modeling/MakeBox.hpp>
 #include <App/Properties/PropertyVector.h>
@@ -12,12 +15,25 @@
 #include <Gui/View/View3DInventorViewer.h>
 #include <Logging/Logging.h>
 #include <App/Application.h>
+#include <QTimer>
 namespace Dev{
 BoxDialog::BoxDialog(Dev::BoxObject *obj, QWidget *parent)
     : BlockDialog(parent), m_object(obj), ui(new Ui::BoxDialog)
 {
     std::string open_commend_name;
     ui->setupUi(this);
+    m_update_timer = new QTimer(this);
+    m_update_timer->setSingleShot(true);
+    m_update_timer->setInterval(150);
+    connect(m_update_timer, &QTimer::timeout, this, [this]()
+            {
+                // 导入事务进行中时不写入形状，稍后重试
+                if (ImportGuard::IsActive())
+                {
+                    m_update_timer->start();
+                    return;
+                }
+                UpdataBoxTopoShape(); });
     if (m_object == nullptr)
     {
         app::OpenCommand(tr("创建 ").toStdString() + "box");
@@ -45,6 +61,11 @@ BoxDialog::~BoxDialog()
 
 bool BoxDialog::OnConfirmed()
 {
+    if (m_update_timer->isActive())
+    {
+        m_update_timer->stop();
+        UpdataBoxTopoShape();
+    }
     app::CommitCommand();
     return true;
 }
@@ -58,6 +79,8 @@ void BoxDialog::OnResetted() {}
 
 void BoxDialog::OnCanceled()
 {
+    // 撤销后对象可能已删除，不能再写入形状
+    m_update_timer->stop();
     app::AbortCommand();
 }
 
@@ -89,24 +112,23 @@ void BoxDialog::OnValueChanged(BlockBase *block, QString property)
 {
     if (qobject_cast<BlockDouble *>(block))
     {
-        UpdataBoxTopoShape();
+        ScheduleUpdate();
     }
     if (qobject_cast<BlockSpecifyPoint *>(block))
     {
-        UpdataBoxTopoShape();
+        ScheduleUpdate();
     }
 }
+
+void BoxDialog::ScheduleUpdate()
+{
+    // 每次输入重新计时，停止输入后才生成形状
+    m_update_timer->start();
+}
 void BoxDialog::UpdataBoxTopoShape()
 {
-    auto l = m_object->GetPropertyFloatValue("Length");
-    auto w = m_object->GetPropertyFloatValue("Width");
-    auto h = m_object->GetPropertyFloatValue("Height");
-    auto p_p = m_object->GetPropertyVector("Position")->GetValue();
-    AMCAX::Point3 position(p_p.x, p_p.y, p_p.z);
-    auto shape = AMCAX::MakeBox(position, l, w, h).Shape();
-
-    auto loc = shape.Location();
-    m_object->Shape.SetValue(shape);
+    auto shape = FeatureBuilder::Build(FeatureBuilder::ReadInput(m_object));
+    ShapeTransaction::SetShape(m_object->Shape, shape);
 }
 
 void BoxDialog::SetSelectionPointSize(int size)
@@ -4,6 +4,8 @@
 #include <Widgets/ContainerBlock/BlockDialog.h>
 #include <Base/Object/BoxObject.h>
 
+class QTimer;
+
 namespace Ui
 {
     class BoxDialog;
@@ -34,10 +36,13 @@ private slots:
 private:
     void ConnectPropertyData(BlockBase *block, std::string property);
     void UpdataBoxTopoShape();
+    // 连续输入时推迟更新形状，一段输入只写入一次Shape
+    void ScheduleUpdate();
     void SetSelectionPointSize(int size);
 
 private:
     Ui::BoxDialog *ui;
     Dev::BoxObject *m_object;
+    QTimer *m_update_timer;
 };
 }
\ No newline at end of file
@@ -15,6 +15,10 @@
 #include <Widgets/Block/BlockString.h>
 #include <Gui/Selection/Selection.h>
 #include <Base/DevSetup.h>
+#include <Base/ElementName.h>
+#include <Base/Object/FeatureBuilder.h>
+#include <Base/ShapeTransaction.h>
+#include <Base/SubShapeIndex.h>
 #include <nurbs/NURBSCurveSection.hpp>
 #include <nurbs/NURBSAPIGetGeometry.hpp>
 #include <nurbs/NURBSAPIConvert.hpp>
@@ -120,12 +124,10 @@ namespace Dev
 		if (!edgeName->GetValue().empty())
 		{
 			auto full_name = std::string(edgeName->GetValue());
-			std::string doc_name;
-			std::string obj_name;
-			std::string sub_name;
-			SplitFullName(full_name, doc_name, obj_name, sub_name);
+			FullNameView name;
+			FullNameView::Parse(full_name, name);
 			selector->SetFocused(true);
-			gui::Selection().AddSelection(doc_name, obj_name, sub_name);
+			gui::Selection().AddSelection(std::string(name.document), std::string(name.object), std::string(name.sub));
 			selector->SetFocused(false);
 		}
 
@@ -157,29 +159,38 @@ namespace Dev
 		app::AbortCommand();
 	}
 
-	std::string GetFullName(const std::string& docname, const std::string& objname, const std::string& subname)
-	{
-		std::string full_name = docname + "." + objname + "." + subname;
-		return full_name;
-	}
-
 	void CurvesLoftDialog::OnCurvesSelectionChanged(const QList<gui::SelectionChanges>& changes)
 	{
 		if (changes.size() > 0)
 		{
 			// 处理最新的拾取曲线
-			auto last_cahnges = changes.last();
-			std::string full_name = GetFullName(last_cahnges.document_name, last_cahnges.object_name, last_cahnges.sub_name);
-			auto part_obj = app::GetApplication().GetActiveDocument()->GetObject(last_cahnges.object_name)->SafeDownCast<app::DocumentObjectTopoShape>();
-			AMCAX::TopoShape edge = part_obj->GetTopoShape(full_name);
-
+			auto const& last_cahnges = changes.last();
 			// 使用qt及信号槽机制，判断是哪个信号触发的槽，从而获取到对应的控件
 			BlockSelectObject* selector = qobject_cast<BlockSelectObject*>(sender());
 			if (!selector)
 				return;
+			// 选择数据包所在的文档中查找对象，不依赖当前活动文档
+			auto found = last_cahnges.GetDocumentObject();
+			auto part_obj = found ? (*found)->SafeDownCast<app::DocumentObjectTopoShape>() : nullptr;
+			if (!part_obj)
+				return;
 
 			// 根据选择器确定是第一条还是第二条曲线
 			int curveIndex = (selector == ui->select1) ? 1 : 2;
+			app::PropertyString* edgeName = (curveIndex == 1) ? m_edge_name1 : m_edge_name2;
+			// 与已保存的名称逐段比较，名称未变化时不拼接完整名称
+			FullNameView current;
+			bool same_name = FullNameView::Parse(edgeName->GetValue(), current) && current.document == last_cahnges.document_name &&
+							 current.object == last_cahnges.object_name && current.sub == last_cahnges.sub_name;
+			std::string full_name;
+			if (!same_name)
+				full_name = MakeFullName(last_cahnges.document_name, last_cahnges.object_name, last_cahnges.sub_name);
+
+			// 通过部件的子形状索引直接定位，索引不可用时退回按完整名称查找
+			AMCAX::TopoShape edge = SubShapeIndex::GetInstance().GetSubShape(part_obj, SubElementId::Parse(last_cahnges.sub_name));
+			if (edge.IsNull())
+				edge = part_obj->GetTopoShape(same_name ? std::string(edgeName->GetValue()) : full_name);
+
 			UpdateCurveSelection(curveIndex, full_name, edge);
 
 			OnPreviewLoft(ui->Preview->GetValue());
@@ -211,30 +222,18 @@ namespace Dev
 			gui::MessageWindow::Warning(tr("警告"), tr("请现在两条曲线"));
 			return AMCAX::TopoFace();
 		}
-		std::vector<AMCAX::NURBSCurveSection> sections;
-		for (auto edge : edges)
-		{
-			auto geo3Curve = AMCAX::NURBSAPIGetGeometry::GetCurve(edge);
-			if (edge.Orientation() == AMCAX::OrientationType::Reversed)
-			{//注意几何Curve的方向和拓扑Edge的方向是无关联的，需要根据拓扑的方向来调整几何的方向
-				geo3Curve->Reverse();
-			}
-			sections.push_back(AMCAX::NURBSCurveSection(geo3Curve));
-		}
-
-		std::shared_ptr<AMCAX::Geom3BSplineSurface> loft;
-		try
-		{
-			loft = AMCAX::NURBSAPILoft::MakeLoft(sections);
-		}
-		catch (...)
+		// 反向、撤销后回到之前的边时直接取缓存的结果
+		FeatureBuilder::Input input;
+		input.kind = FeatureBuilder::Kind::CurvesLoft;
+		input.edge1 = edges[0];
+		input.edge2 = edges[1];
+		AMCAX::TopoShape shape = FeatureBuilder::Build(input);
+		if (shape.IsNull())
 		{
 			gui::MessageWindow::Error(tr("错误"), tr("放样失败！"));
 			return AMCAX::TopoFace();
 		}
-		AMCAX::MakeFace surface(loft, 1e-6);
-		AMCAX::TopoFace topoface = surface.Face();
-		return topoface;
+		return static_cast<const AMCAX::TopoFace&>(shape);
 	}
 
 	/**
@@ -263,12 +262,12 @@ namespace Dev
 			auto face = StartLoft(edges);
 			if (auto shape = static_cast<AMCAX::TopoShape&>(face); !shape.IsNull())
 			{
-				m_object->Shape.SetValue(shape);
+				ShapeTransaction::SetShape(m_object->Shape, shape);
 			}
 		}
 		else
 		{
-			m_object->Shape.SetValue(AMCAX::TopoShape{});
+			ShapeTransaction::SetShape(m_object->Shape, AMCAX::TopoShape{});
 		}
 	}
 
@@ -297,30 +296,6 @@ namespace Dev
 		render->pluginManage->SetProperty(id, att);
 		return id; // 返回箭头实体的ID，用于后续控制
 	}
-	bool CurvesLoftDialog::SplitFullName(std::string id_name, std::string& document_name, std::string& object_name, std::string& sub_name)
-	{
-		document_name = "";
-		object_name = "";
-		sub_name = "";
-		std::vector<std::string> name_list;
-
-		std::stringstream ss(id_name);
-		std::string name;
-
-		while (std::getline(ss, name, '.'))
-		{
-			name_list.push_back(name);
-		}
-
-		if (name_list.size() == 3)
-		{
-			document_name = name_list[0];
-			object_name = name_list[1];
-			sub_name = name_list[2];
-			return true;
-		}
-		return false;
-	}
 	void CurvesLoftDialog::RefreshRenderWindow()
 	{
 		gui::GetMainWindow()->ActiveWindow()->OnMessage("Refresh"); // 刷新界面
@@ -338,8 +313,9 @@ namespace Dev
 		app::PropertyTopoShape* topoShape = (curveIndex == 1) ? m_topo_shape1 : m_topo_shape2;
 		AMCAXRender::EntityId& renderId = (curveIndex == 1) ? m_curve1_render_id : m_curve2_render_id;
 
-		// 更新edge名称
-		edgeName->SetValue(full_name);
+		// 更新edge名称，为空表示名称未变化
+		if (!full_name.empty())
+			edgeName->SetValue(full_name);
 
 		// 重新更新edge的方向渲染
 		if (!edge.IsNull())
@@ -46,8 +46,6 @@ namespace Dev
     // 渲染拾取曲线的起始方向
     AMCAXRender::EntityId RenderEdgeDirection(AMCAX::TopoEdge &edge);
 
-    bool SplitFullName(std::string id_name, std::string &document_name, std::string &object_name, std::string &sub_name);
-
     // 刷新渲染窗口
     void RefreshRenderWindow();
 
@@ -62,7 +60,7 @@ namespace Dev
     // 初始化选择器控件
     void InitSelector(BlockSelectObject* selector, app::PropertyString* edgeName);
 
-    // 更新指定曲线的选择和渲染（curveIndex: 1 或 2）
+    // 更新指定曲线的选择和渲染（curveIndex: 1 或 2），full_name为空时保留原名称
     void UpdateCurveSelection(int curveIndex, const std::string& full_name, const AMCAX::TopoShape& edge);
 
     // 反转指定曲线的方向（curveIndex: 1 或 2）
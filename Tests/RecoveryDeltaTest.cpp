@@ -0,0 +1,92 @@
+#include <Base/Storage/RecoveryDelta.h>
+#include <catch2/catch_test_macros.hpp>
+#include <sstream>
+#include <string>
+
+using Dev::RecoveryDelta;
+
+namespace
+{
+    std::vector<RecoveryDelta::Record> MakeRecords()
+    {
+        std::vector<RecoveryDelta::Record> records(2);
+        records[0].op = RecoveryDelta::Operation::Update;
+        records[0].name = "Part001";
+        records[0].label = "Label";
+        records[0].solid_color = 0x11223344u;
+        records[0].face_colors = {{0, 0xff0000ffu}, {7, 0x00ff00ffu}};
+        records[0].face_names = {{"Face1", "Top"}, {"Face8", "Side"}};
+        records[0].shape = std::string("shape\0data", 10);
+        records[1].op = RecoveryDelta::Operation::Remove;
+        records[1].name = "Part002";
+        return records;
+    }
+
+    std::string Encode(const std::vector<RecoveryDelta::Record> &records)
+    {
+        std::ostringstream oss(std::ios::binary);
+        REQUIRE(RecoveryDelta::Write(oss, records));
+        return oss.str();
+    }
+
+    bool Decode(const std::string &bytes, std::vector<RecoveryDelta::Record> &records)
+    {
+        std::istringstream iss(bytes, std::ios::binary);
+        return RecoveryDelta::Read(iss, bytes.size(), records);
+    }
+} // namespace
+
+TEST_CASE("RecoveryDelta round-trips records", "[RecoveryDelta]")
+{
+    auto records = MakeRecords();
+    std::vector<RecoveryDelta::Record> decoded;
+    REQUIRE(Decode(Encode(records), decoded));
+    REQUIRE(decoded.size() == records.size());
+
+    CHECK(decoded[0].op == RecoveryDelta::Operation::Update);
+    CHECK(decoded[0].name == records[0].name);
+    CHECK(decoded[0].label == records[0].label);
+    CHECK(decoded[0].solid_color == records[0].solid_color);
+    CHECK(decoded[0].face_colors == records[0].face_colors);
+    CHECK(decoded[0].face_names == records[0].face_names);
+    CHECK(decoded[0].shape == records[0].shape);
+
+    CHECK(decoded[1].op == RecoveryDelta::Operation::Remove);
+    CHECK(decoded[1].name == records[1].name);
+}
+
+TEST_CASE("RecoveryDelta rejects every truncation", "[RecoveryDelta]")
+{
+    auto bytes = Encode(MakeRecords());
+    for (std::size_t size = 0; size < bytes.size(); ++size)
+    {
+        std::vector<RecoveryDelta::Record> decoded;
+        INFO("size " << size);
+        CHECK_FALSE(Decode(bytes.substr(0, size), decoded));
+    }
+}
+
+TEST_CASE("RecoveryDelta checks lengths against the given size", "[RecoveryDelta]")
+{
+    auto bytes = Encode(MakeRecords());
+    // 流中有完整数据，但声明的长度不足时仍不能越界读取
+    std::istringstream iss(bytes, std::ios::binary);
+    std::vector<RecoveryDelta::Record> decoded;
+    CHECK_FALSE(RecoveryDelta::Read(iss, bytes.size() - 1, decoded));
+}
+
+TEST_CASE("RecoveryDelta rejects counts larger than the data", "[RecoveryDelta]")
+{
+    auto bytes = Encode(MakeRecords());
+    // 标识、版本之后是记录数
+    for (int i = 0; i < 4; ++i)
+        bytes[8 + i] = static_cast<char>(0xff);
+    std::vector<RecoveryDelta::Record> decoded;
+    CHECK_FALSE(Decode(bytes, decoded));
+
+    // 第一条记录的名称长度
+    bytes = Encode(MakeRecords());
+    for (int i = 0; i < 8; ++i)
+        bytes[13 + i] = static_cast<char>(0xff);
+    CHECK_FALSE(Decode(bytes, decoded));
+}
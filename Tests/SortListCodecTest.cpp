@@ -0,0 +1,76 @@
+#include <Base/Storage/SortListCodec.h>
+#include <catch2/catch_test_macros.hpp>
+#include <sstream>
+#include <string>
+
+using Dev::SortListCodec;
+
+namespace
+{
+    SortListCodec::Data MakeData()
+    {
+        SortListCodec::Data data;
+        data.nav_sort_list[0]["Parts"] = {"Part", "Part001", "Part002"};
+        data.nav_sort_list[3]["Features"] = {"Box", "Loft"};
+        data.nav_sort_list[3]["Empty"] = {};
+        data.part_sort_list[""] = {"Part002", "Part", "Part001"};
+        return data;
+    }
+
+    std::string Encode(const SortListCodec::Data &data)
+    {
+        std::ostringstream oss(std::ios::binary);
+        REQUIRE(SortListCodec::Write(oss, data));
+        return oss.str();
+    }
+
+    bool Decode(const std::string &bytes, SortListCodec::Data &data)
+    {
+        std::istringstream iss(bytes, std::ios::binary);
+        return SortListCodec::Read(iss, data);
+    }
+
+    void PutU32(std::string &bytes, std::size_t pos, std::uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+            bytes[pos + i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+} // namespace
+
+TEST_CASE("SortListCodec round-trips sort lists", "[SortListCodec]")
+{
+    auto data = MakeData();
+    SortListCodec::Data decoded;
+    REQUIRE(Decode(Encode(data), decoded));
+    CHECK(decoded.nav_sort_list == data.nav_sort_list);
+    CHECK(decoded.part_sort_list == data.part_sort_list);
+}
+
+TEST_CASE("SortListCodec round-trips empty data", "[SortListCodec]")
+{
+    SortListCodec::Data decoded;
+    decoded.part_sort_list[""] = {"stale"};
+    REQUIRE(Decode(Encode({}), decoded));
+    CHECK(decoded.nav_sort_list.empty());
+    CHECK(decoded.part_sort_list.empty());
+}
+
+TEST_CASE("SortListCodec rejects every truncation", "[SortListCodec]")
+{
+    auto bytes = Encode(MakeData());
+    for (std::size_t size = 0; size < bytes.size(); ++size)
+    {
+        SortListCodec::Data decoded;
+        INFO("size " << size);
+        CHECK_FALSE(Decode(bytes.substr(0, size), decoded));
+    }
+}
+
+TEST_CASE("SortListCodec rejects counts larger than the data", "[SortListCodec]")
+{
+    auto bytes = Encode(MakeData());
+    // 标识、版本之后是字符串数量
+    PutU32(bytes, 8, 0xffffffffu);
+    SortListCodec::Data decoded;
+    CHECK_FALSE(Decode(bytes, decoded));
+}